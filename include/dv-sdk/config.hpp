@@ -854,6 +854,45 @@ public:
 	}
 };
 
+/**
+ * Typed, pre-resolved handle to the current value of a config option.
+ * Obtained from `RuntimeConfig::handle()`. Reading the value is a plain
+ * memory load, without any key lookup or type check. The value is kept
+ * up-to-date by `RuntimeConfig::update()`, called on every configuration
+ * change before `configUpdate()`, and by `RuntimeConfig::set()`.
+ * A handle stays valid as long as its option is not re-added.
+ * @tparam T The config variant type
+ */
+template<dv::Config::AttributeType T> class ConfigHandle {
+public:
+	using value_type = typename dv::Config::AttributeTypeGenerator<T>::type;
+
+private:
+	const value_type *value = nullptr;
+
+public:
+	ConfigHandle() = default;
+
+	explicit ConfigHandle(const value_type &currentValue) : value(&currentValue) {
+	}
+
+	/**
+	 * Returns the current value of the config option.
+	 * @return A simple value (long, string etc) that is the current value of the config option
+	 */
+	const value_type &get() const {
+		return (*value);
+	}
+
+	const value_type &operator*() const {
+		return (*value);
+	}
+
+	operator const value_type &() const {
+		return (*value);
+	}
+};
+
 class RuntimeConfig {
 private:
 	std::unordered_map<std::string, ConfigOption> configMap;
@@ -910,6 +949,28 @@ public:
 		cfg.set<T>(value);
 	}
 
+	/**
+	 * Returns a typed handle to the value of the given config option, that
+	 * can be stored and read without further lookups.
+	 * @tparam T The config variant type
+	 * @param key The config option to get the handle of
+	 * @return A handle to the current value of the config option
+	 */
+	template<dv::Config::AttributeType T> ConfigHandle<T> handle(const std::string &key) const {
+		if (configMap.count(key) == 0) {
+			throw std::out_of_range("RuntimeConfig.handle(\"" + key + "\"): key doesn't exist.");
+		}
+
+		auto &cfg = configMap.at(key);
+
+		if (cfg.getType() != T) {
+			throw std::runtime_error(
+				"RuntimeConfig.handle(\"" + key + "\"): key type and given template type are not the same.");
+		}
+
+		return (ConfigHandle<T>(cfg.get<T>()));
+	}
+
 	bool changed(const std::string &key) {
 		if (configMap.count(key) == 0) {
 			throw std::out_of_range("RuntimeConfig.changed(\"" + key + "\"): key doesn't exist.");
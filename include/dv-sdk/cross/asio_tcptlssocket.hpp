@@ -1,27 +1,50 @@
 #ifndef DV_SDK_ASIO_TCPTLSSOCKET_HPP_
 #define DV_SDK_ASIO_TCPTLSSOCKET_HPP_
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/version.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <deque>
+#include <functional>
 #include <utility>
+#include <vector>
 
 namespace asio    = boost::asio;
 namespace asioSSL = asio::ssl;
 namespace asioIP  = asio::ip;
 using asioTCP     = asioIP::tcp;
 
-class TCPTLSSocket {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+using asioLocal = asio::local::stream_protocol;
+
+// Passing file descriptors (SCM_RIGHTS) over Unix domain sockets needs async_wait().
+#	if defined(BOOST_VERSION) && (BOOST_VERSION / 100000) == 1 && (BOOST_VERSION / 100 % 1000) >= 66
+#		define DV_ASIO_FD_PASSING 1
+#	endif
+#endif
+
+/**
+ * Stream socket with optional TLS, for TCP or Unix domain sockets
+ * (without TLS, and without the address based accessors).
+ */
+template<typename Protocol> class BasicTLSSocket {
+public:
+	using socket_type   = typename Protocol::socket;
+	using endpoint_type = typename Protocol::endpoint;
+
 private:
-	asioTCP::endpoint localEndpoint;
-	asioTCP::endpoint remoteEndpoint;
-	asioSSL::stream<asioTCP::socket> socket;
+	endpoint_type localEndpoint;
+	endpoint_type remoteEndpoint;
+	asioSSL::stream<socket_type> socket;
 	bool socketClosed;
 	bool secureConnection;
 
 public:
-	TCPTLSSocket(asioTCP::socket s, bool tlsEnabled, asioSSL::context *tlsContext) :
+	BasicTLSSocket(socket_type s, bool tlsEnabled, asioSSL::context *tlsContext) :
 		localEndpoint(s.local_endpoint()),
 		remoteEndpoint(s.remote_endpoint()),
 #if defined(BOOST_VERSION) && (BOOST_VERSION / 100000) == 1 && (BOOST_VERSION / 100 % 1000) >= 66
@@ -36,7 +59,7 @@ public:
 #endif
 	}
 
-	~TCPTLSSocket() {
+	~BasicTLSSocket() {
 		close();
 	}
 
@@ -52,7 +75,7 @@ public:
 		// for our protocol, we can safely ignore it.
 		if (!socketClosed) {
 			boost::system::error_code ec;
-			baseSocket().shutdown(asioTCP::socket::shutdown_both, ec);
+			baseSocket().shutdown(socket_type::shutdown_both, ec);
 			baseSocket().close(ec);
 
 			socketClosed = true;
@@ -91,6 +114,85 @@ public:
 #pragma GCC diagnostic pop
 	}
 
+	/**
+	 * Write all buffers in order, as one operation.
+	 * Write handler needs following signature:
+	 * void (const boost::system::error_code &, size_t)
+	 */
+	template<typename WriteHandler>
+	void write(const std::vector<asio::const_buffer> &bufs, WriteHandler &&wrHandler) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+		if (secureConnection) {
+			asio::async_write(socket, bufs, wrHandler);
+		}
+		else {
+			asio::async_write(baseSocket(), bufs, wrHandler);
+		}
+#pragma GCC diagnostic pop
+	}
+
+#if defined(DV_ASIO_FD_PASSING)
+	/**
+	 * Write all buffers in order, as one operation, passing a file
+	 * descriptor along with the first bytes (SCM_RIGHTS). Only for Unix
+	 * domain sockets without TLS. The descriptor must stay open until
+	 * the handler is called.
+	 * Write handler needs following signature:
+	 * void (const boost::system::error_code &, size_t)
+	 */
+	template<typename WriteHandler>
+	void writeWithFileDescriptor(std::vector<asio::const_buffer> bufs, int fd, WriteHandler &&wrHandler) {
+		baseSocket().async_wait(socket_type::wait_write,
+			[this, bufs = std::move(bufs), fd, wrHandler = std::forward<WriteHandler>(wrHandler)](
+				const boost::system::error_code &error) mutable {
+				if (error) {
+					wrHandler(error, 0);
+					return;
+				}
+
+				const ssize_t sent = sendFileDescriptor(bufs, fd);
+
+				if (sent < 0) {
+					if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+						// Socket buffer filled up in the meantime, wait again.
+						writeWithFileDescriptor(std::move(bufs), fd, std::move(wrHandler));
+					}
+					else {
+						wrHandler(boost::system::error_code(errno, boost::system::system_category()), 0);
+					}
+
+					return;
+				}
+
+				// The descriptor went with the first bytes, write the rest as usual.
+				std::vector<asio::const_buffer> rest;
+				size_t skip = static_cast<size_t>(sent);
+
+				for (const auto &buf : bufs) {
+					if (skip >= buf.size()) {
+						skip -= buf.size();
+						continue;
+					}
+
+					rest.push_back(buf + skip);
+					skip = 0;
+				}
+
+				if (rest.empty()) {
+					wrHandler(boost::system::error_code(), static_cast<size_t>(sent));
+					return;
+				}
+
+				asio::async_write(baseSocket(), rest,
+					[sent, wrHandler = std::move(wrHandler)](
+						const boost::system::error_code &writeError, size_t length) mutable {
+						wrHandler(writeError, static_cast<size_t>(sent) + length);
+					});
+			});
+	}
+#endif
+
 	/**
 	 * Read handler needs following signature:
 	 * void (const boost::system::error_code &, size_t)
@@ -109,7 +211,7 @@ public:
 #pragma GCC diagnostic pop
 	}
 
-	asioTCP::endpoint local_endpoint() const {
+	endpoint_type local_endpoint() const {
 		return (localEndpoint);
 	}
 
@@ -121,7 +223,7 @@ public:
 		return (local_endpoint().port());
 	}
 
-	asioTCP::endpoint remote_endpoint() const {
+	endpoint_type remote_endpoint() const {
 		return (remoteEndpoint);
 	}
 
@@ -133,58 +235,428 @@ public:
 		return (remote_endpoint().port());
 	}
 
-private:
-	asioTCP::socket &baseSocket() {
+	bool isSecureConnection() const {
+		return (secureConnection);
+	}
+
+	/**
+	 * Send data as soon as possible (TCP_NODELAY), instead of letting
+	 * the kernel coalesce small segments (Nagle's algorithm).
+	 */
+	void setNoDelay(bool enable) {
+		boost::system::error_code ec;
+		baseSocket().set_option(asioTCP::no_delay(enable), ec);
+	}
+
+	/**
+	 * Hold back partial segments until uncorked (TCP_CORK).
+	 * Does nothing on systems without TCP_CORK.
+	 */
+	void setCork(bool enable) {
+#if defined(TCP_CORK)
+		boost::system::error_code ec;
+		baseSocket().set_option(asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_CORK>(enable), ec);
+#else
+		(void) (enable);
+#endif
+	}
+
+protected:
+	socket_type &baseSocket() {
 		return (socket.next_layer());
 	}
+
+private:
+#if defined(DV_ASIO_FD_PASSING)
+	/**
+	 * Non-blocking sendmsg() of as much of the buffers as possible, with
+	 * the file descriptor as ancillary data.
+	 *
+	 * @return bytes sent, or -1 with errno set.
+	 */
+	ssize_t sendFileDescriptor(const std::vector<asio::const_buffer> &bufs, int fd) {
+		std::vector<struct iovec> iov;
+
+		for (const auto &buf : bufs) {
+			iov.push_back({const_cast<void *>(buf.data()), buf.size()});
+		}
+
+		union {
+			struct cmsghdr align;
+			char data[CMSG_SPACE(sizeof(int))];
+		} control;
+		std::memset(&control, 0, sizeof(control));
+
+		struct msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov        = iov.data();
+		msg.msg_iovlen     = iov.size();
+		msg.msg_control    = control.data;
+		msg.msg_controllen = sizeof(control.data);
+
+		struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level     = SOL_SOCKET;
+		cmsg->cmsg_type      = SCM_RIGHTS;
+		cmsg->cmsg_len       = CMSG_LEN(sizeof(int));
+		std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+		int flags = MSG_DONTWAIT;
+#	if defined(MSG_NOSIGNAL)
+		flags |= MSG_NOSIGNAL;
+#	endif
+
+		return (::sendmsg(baseSocket().native_handle(), &msg, flags));
+	}
+#endif
 };
 
-class TCPTLSWriteOrderedSocket : public TCPTLSSocket {
+using TCPTLSSocket = BasicTLSSocket<asioTCP>;
+
+/// What to do when a write would exceed the limits of the write queue.
+enum class TCPTLSWriteQueuePolicy {
+	/// Drop the oldest pending writes.
+	DROP_OLDEST,
+	/// Drop the oldest pending non-keyframe writes, then the oldest ones.
+	DROP_NON_KEYFRAME,
+	/// Refuse the write, the caller is expected to close the connection.
+	DISCONNECT,
+};
+
+template<typename Protocol> class BasicTLSWriteOrderedSocket : public BasicTLSSocket<Protocol> {
+private:
+	using WriteHandlerFunction = std::function<void(const boost::system::error_code &, size_t)>;
+
+	struct WriteRequest {
+		std::vector<asio::const_buffer> buffers;
+		// Including the data held by the file descriptor.
+		size_t size;
+		bool keyframe;
+		// Passed along with the buffers if valid, never batched with other writes.
+		int fileDescriptor;
+		WriteHandlerFunction handler;
+	};
+
+	// No locking for writeQueue because all changes are posted to io_service thread.
+	// The front writingMessages requests are the ones currently being written.
+	std::deque<WriteRequest> writeQueue;
+	size_t writeQueueBytes;
+	size_t writingMessages;
+
+	// Coalescing of pending writes, zero means disabled.
+	size_t maxBatchBytes;
+	std::chrono::microseconds maxBatchDelay;
+	asio::steady_timer batchTimer;
+	bool batchTimerArmed;
+	// TLS encrypts each buffer separately, so batches are copied together.
+	std::vector<uint8_t> batchBuffer;
+
+	bool corkWrites;
+	bool corked;
+
+	// Limits, zero means unlimited.
+	size_t maxQueueBytes;
+	size_t maxQueueMessages;
+	TCPTLSWriteQueuePolicy queuePolicy;
+
+	uint64_t droppedMessages;
+	uint64_t droppedBytes;
+
 public:
-	TCPTLSWriteOrderedSocket(asioTCP::socket s, bool tlsEnabled, asioSSL::context *tlsContext) :
-		TCPTLSSocket(std::move(s), tlsEnabled, tlsContext) {
+	BasicTLSWriteOrderedSocket(
+		typename BasicTLSSocket<Protocol>::socket_type s, bool tlsEnabled, asioSSL::context *tlsContext) :
+		BasicTLSSocket<Protocol>(std::move(s), tlsEnabled, tlsContext),
+		writeQueueBytes(0),
+		writingMessages(0),
+		maxBatchBytes(0),
+		maxBatchDelay(0),
+#if defined(BOOST_VERSION) && (BOOST_VERSION / 100000) == 1 && (BOOST_VERSION / 100 % 1000) >= 70
+		batchTimer(this->baseSocket().get_executor()),
+#else
+		batchTimer(this->baseSocket().get_io_service()),
+#endif
+		batchTimerArmed(false),
+		corkWrites(false),
+		corked(false),
+		maxQueueBytes(0),
+		maxQueueMessages(0),
+		queuePolicy(TCPTLSWriteQueuePolicy::DROP_OLDEST),
+		droppedMessages(0),
+		droppedBytes(0) {
+	}
+
+	/**
+	 * Limit the pending writes. Writes in progress are never dropped, and
+	 * a new write is accepted once enough others were dropped, so the queue
+	 * exceeds the limits by at most those and one write. Unlimited by default.
+	 *
+	 * @param maxBytes maximum bytes queued, zero for unlimited.
+	 * @param maxMessages maximum writes queued, zero for unlimited.
+	 * @param policy what to do when a write would exceed the limits.
+	 */
+	void setWriteQueueLimits(size_t maxBytes, size_t maxMessages, TCPTLSWriteQueuePolicy policy) {
+		maxQueueBytes    = maxBytes;
+		maxQueueMessages = maxMessages;
+		queuePolicy      = policy;
+	}
+
+	/**
+	 * Coalesce pending writes into one socket write, to reduce system calls
+	 * (and TLS records). Disabled by default.
+	 *
+	 * @param maxBytes maximum bytes written at once, zero to write each separately.
+	 * @param maxDelay maximum time to wait for more writes before starting
+	 * one smaller than maxBytes, zero to never wait.
+	 * @param cork hold back partial TCP segments while writes follow each other.
+	 */
+	void setWriteBatching(size_t maxBytes, std::chrono::microseconds maxDelay, bool cork) {
+		maxBatchBytes = maxBytes;
+		maxBatchDelay = maxDelay;
+		corkWrites    = cork;
+
+		if (!corkWrites && corked) {
+			this->setCork(false);
+			corked = false;
+		}
+	}
+
+	size_t getWriteQueueBytes() const {
+		return (writeQueueBytes);
+	}
+
+	size_t getWriteQueueMessages() const {
+		return (writeQueue.size());
+	}
+
+	uint64_t getDroppedMessages() const {
+		return (droppedMessages);
+	}
+
+	uint64_t getDroppedBytes() const {
+		return (droppedBytes);
 	}
 
 	/**
 	 * Write handler needs following signature:
 	 * void (const boost::system::error_code &, size_t)
 	 */
-	template<typename WriteHandler> void write(const asio::const_buffer &buf, WriteHandler &&wrHandler) {
-		std::function<void(const boost::system::error_code &, size_t)> orderedHandler
-			= [this, wrHandler](const boost::system::error_code &error, size_t length) {
-				  // Execute bound handler.
-				  wrHandler(error, length);
-
-				  // Remove currently executing handler from queue (placeholder only).
-				  writeQueue.pop_front();
-
-				  // On error, clear pending writes and do nothing.
-				  if (error) {
-					  writeQueue.clear();
-				  }
-				  else {
-					  // Start new writes.
-					  if (!writeQueue.empty()) {
-						  TCPTLSSocket::write(writeQueue.front().first, writeQueue.front().second);
-					  }
-				  }
-			  };
-
-		// Check current status.
-		bool noWrites = writeQueue.empty();
+	template<typename WriteHandler> bool write(const asio::const_buffer &buf, WriteHandler &&wrHandler) {
+		return (write(std::vector<asio::const_buffer>{buf}, false, std::forward<WriteHandler>(wrHandler)));
+	}
+
+	/**
+	 * Queue a write of all buffers, which are kept together and dropped
+	 * together. The handler of a dropped write is never called, it is
+	 * only destroyed.
+	 * Write handler needs following signature:
+	 * void (const boost::system::error_code &, size_t)
+	 *
+	 * @param bufs buffers to write in order.
+	 * @param keyframe whether the write should be kept over non-keyframes.
+	 * @param wrHandler called once the write completed or failed.
+	 * @param fileDescriptor passed along with the buffers, -1 for none.
+	 * Needs DV_ASIO_FD_PASSING and a Unix domain socket without TLS,
+	 * ignored otherwise. Must stay open until the handler is called.
+	 * @param fileDescriptorSize bytes of data held by the descriptor,
+	 * counted towards the write queue limits.
+	 *
+	 * @return false if the write was refused due to the DISCONNECT policy.
+	 */
+	template<typename WriteHandler>
+	bool write(std::vector<asio::const_buffer> bufs, bool keyframe, WriteHandler &&wrHandler, int fileDescriptor = -1,
+		size_t fileDescriptorSize = 0) {
+		const size_t size = asio::buffer_size(bufs) + ((fileDescriptor >= 0) ? (fileDescriptorSize) : (0));
+
+		while (exceedsWriteQueueLimits(size)) {
+			const auto drop = findDroppableWrite(keyframe);
+
+			if (drop == writeQueue.end()) {
+				if ((queuePolicy == TCPTLSWriteQueuePolicy::DROP_NON_KEYFRAME) && !keyframe
+					&& (writeQueue.size() > writingMessages)) {
+					// Only keyframes pending, drop the new write instead.
+					droppedMessages++;
+					droppedBytes += size;
+					return (true);
+				}
+
+				// Only writes in progress are left.
+				break;
+			}
+
+			if (queuePolicy == TCPTLSWriteQueuePolicy::DISCONNECT) {
+				return (false);
+			}
+
+			droppedMessages++;
+			droppedBytes += drop->size;
+			writeQueueBytes -= drop->size;
+
+			writeQueue.erase(drop);
+		}
 
 		// Enqueue all writes.
-		writeQueue.emplace_back(buf, orderedHandler);
+		writeQueue.push_back(WriteRequest{std::move(bufs), size, keyframe, fileDescriptor,
+			WriteHandlerFunction(std::forward<WriteHandler>(wrHandler))});
+		writeQueueBytes += size;
 
-		if (noWrites) {
+		if (writingMessages == 0) {
 			// Start first write.
-			TCPTLSSocket::write(writeQueue.front().first, writeQueue.front().second);
+			scheduleWrite();
 		}
+
+		return (true);
 	}
 
 private:
-	std::deque<std::pair<asio::const_buffer, std::function<void(const boost::system::error_code &, size_t)>>>
-		writeQueue; // No locking for writeQueue because all changes are posted to io_service thread.
+	bool exceedsWriteQueueLimits(size_t size) const {
+		return (((maxQueueMessages > 0) && ((writeQueue.size() + 1) > maxQueueMessages))
+				|| ((maxQueueBytes > 0) && ((writeQueueBytes + size) > maxQueueBytes)));
+	}
+
+	typename std::deque<WriteRequest>::iterator findDroppableWrite(bool keyframe) {
+		// Writes in progress can't be dropped.
+		if (writeQueue.size() <= writingMessages) {
+			return (writeQueue.end());
+		}
+
+		const auto oldest = writeQueue.begin() + static_cast<std::ptrdiff_t>(writingMessages);
+
+		if (queuePolicy == TCPTLSWriteQueuePolicy::DROP_NON_KEYFRAME) {
+			const auto nonKeyframe = std::find_if(oldest, writeQueue.end(), [](const WriteRequest &req) {
+				return (!req.keyframe);
+			});
+
+			// Keyframes only make room for other keyframes.
+			if ((nonKeyframe != writeQueue.end()) || !keyframe) {
+				return (nonKeyframe);
+			}
+		}
+
+		return (oldest);
+	}
+
+	void scheduleWrite() {
+		const bool noBatching = (maxBatchBytes == 0) || (maxBatchDelay.count() == 0);
+
+		if (noBatching || (writeQueueBytes >= maxBatchBytes)) {
+			startWrite();
+			return;
+		}
+
+		if (batchTimerArmed) {
+			return;
+		}
+
+		// Wait a bit for more writes to coalesce.
+		batchTimerArmed = true;
+
+#if defined(BOOST_VERSION) && (BOOST_VERSION / 100000) == 1 && (BOOST_VERSION / 100 % 1000) >= 66
+		batchTimer.expires_after(maxBatchDelay);
+#else
+		batchTimer.expires_from_now(maxBatchDelay);
+#endif
+
+		batchTimer.async_wait([this](const boost::system::error_code &error) {
+			if (error) {
+				return;
+			}
+
+			batchTimerArmed = false;
+
+			// A full batch may have been started in the meantime.
+			if ((writingMessages == 0) && !writeQueue.empty()) {
+				startWrite();
+			}
+		});
+	}
+
+	void startWrite() {
+		// Coalesce pending writes, up to the batch size (always at least one).
+		// Writes passing a file descriptor are always written alone.
+		std::vector<asio::const_buffer> buffers;
+		std::vector<WriteHandlerFunction> handlers;
+		size_t batchBytes = 0;
+		int fileDescriptor = -1;
+
+		for (const auto &req : writeQueue) {
+			if (!handlers.empty() && (((batchBytes + req.size) > maxBatchBytes) || (req.fileDescriptor >= 0))) {
+				break;
+			}
+
+			buffers.insert(buffers.end(), req.buffers.begin(), req.buffers.end());
+			handlers.push_back(req.handler);
+			batchBytes += req.size;
+
+			if (req.fileDescriptor >= 0) {
+				fileDescriptor = req.fileDescriptor;
+				break;
+			}
+		}
+
+		writingMessages = handlers.size();
+
+		if (corkWrites && !corked) {
+			this->setCork(true);
+			corked = true;
+		}
+
+		if (this->isSecureConnection() && (buffers.size() > 1)) {
+			batchBuffer.resize(asio::buffer_size(buffers));
+			asio::buffer_copy(asio::buffer(batchBuffer), buffers);
+
+			buffers.assign(1, asio::buffer(batchBuffer));
+		}
+
+#if defined(DV_ASIO_FD_PASSING)
+		if ((fileDescriptor >= 0) && !this->isSecureConnection()) {
+			this->writeWithFileDescriptor(std::move(buffers), fileDescriptor, writeCompletion(std::move(handlers)));
+			return;
+		}
+#else
+		(void) (fileDescriptor);
+#endif
+
+		BasicTLSSocket<Protocol>::write(buffers, writeCompletion(std::move(handlers)));
+	}
+
+	/**
+	 * The asio handler holds its own copy of the bound handlers, so that
+	 * anything they keep alive survives until the queue was updated.
+	 */
+	auto writeCompletion(std::vector<WriteHandlerFunction> handlers) {
+		return ([this, handlers = std::move(handlers)](const boost::system::error_code &error, size_t /*length*/) {
+			// Execute bound handlers.
+			for (size_t i = 0; i < handlers.size(); i++) {
+				handlers[i](error, writeQueue[i].size);
+			}
+
+			// Remove completed writes from queue.
+			for (size_t i = 0; i < handlers.size(); i++) {
+				writeQueueBytes -= writeQueue.front().size;
+				writeQueue.pop_front();
+			}
+
+			writingMessages = 0;
+
+			// On error, clear pending writes and do nothing.
+			if (error) {
+				writeQueue.clear();
+				writeQueueBytes = 0;
+			}
+			else {
+				// Start new writes.
+				if (!writeQueue.empty()) {
+					scheduleWrite();
+				}
+				else if (corked) {
+					// Idle, flush what the kernel held back.
+					this->setCork(false);
+					corked = false;
+				}
+			}
+		});
+	}
 };
 
+using TCPTLSWriteOrderedSocket = BasicTLSWriteOrderedSocket<asioTCP>;
+
 #endif /* DV_SDK_ASIO_TCPTLSSOCKET_HPP_ */
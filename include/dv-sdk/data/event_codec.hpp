@@ -0,0 +1,407 @@
+#ifndef DV_SDK_EVENT_CODEC_HPP
+#define DV_SDK_EVENT_CODEC_HPP
+
+#include "event_base.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace dv {
+
+/**
+ * Compact encoding for event packets, exploiting their structure instead of
+ * relying on a generic compressor: timestamps are stored as zig-zag encoded
+ * deltas, coordinates with just as many bits as the largest one needs, and
+ * polarities as a bitmap.
+ *
+ * Events are processed in blocks of 128, split over 4 interleaved lanes
+ * (event i goes to lane i % 4). Each field is bit-packed separately per lane
+ * at the width of the block (timestamps) or of the packet (coordinates), so
+ * that all lanes shift by the same amounts: packing and unpacking map
+ * directly to 128-bit SIMD (SSE2, NEON), which compilers vectorize.
+ *
+ * Layout, all little-endian:
+ *   uint32  number of events
+ *   uint8   format version (1)
+ *   uint8   bits per X coordinate
+ *   uint8   bits per Y coordinate
+ *   uint8   reserved
+ *   int64   timestamp of the first event
+ *   uint8   bits per timestamp delta, for each block, padded to 4 bytes
+ *   per block, 4 * bits 32-bit words for each of: delta (low 32 bits),
+ *   delta (high 32 bits, only if wider than 32 bits), X, Y, polarity
+ */
+class EventPacketCodec {
+public:
+	static constexpr uint8_t VERSION       = 1;
+	static constexpr size_t LANES          = 4;
+	static constexpr size_t BLOCK_SIZE     = 32 * LANES;
+	static constexpr size_t HEADER_SIZE    = 16;
+	static constexpr uint32_t MAX_TS_BITS  = 64;
+	static constexpr uint32_t MAX_XY_BITS  = 16;
+	static constexpr uint32_t POLARITY_BIT = 1;
+
+	/**
+	 * Maximum size in bytes of the encoding of the given number of events.
+	 *
+	 * @param eventCount number of events.
+	 *
+	 * @return maximum encoded size in bytes.
+	 */
+	static size_t encodedSizeBound(size_t eventCount) {
+		const size_t blocks = getBlocksNumber(eventCount);
+
+		return (HEADER_SIZE + getBlockBitsSize(blocks)
+				+ (blocks * getPackedSize(MAX_TS_BITS + (2 * MAX_XY_BITS) + POLARITY_BIT)));
+	}
+
+	/**
+	 * Encode events. Timestamps are expected to be mostly increasing,
+	 * as they are in any event packet, but any order is supported.
+	 *
+	 * @param events events to encode.
+	 * @param eventCount number of events.
+	 * @param out output buffer, must hold at least encodedSizeBound(eventCount) bytes.
+	 *
+	 * @return encoded size in bytes.
+	 */
+	static size_t encode(const Event *events, size_t eventCount, uint8_t *out) {
+		if (eventCount > UINT32_MAX) {
+			throw std::length_error("too many events to encode.");
+		}
+
+		// Coordinate widths are shared by the whole packet.
+		uint16_t xMask = 0;
+		uint16_t yMask = 0;
+
+		for (size_t i = 0; i < eventCount; i++) {
+			xMask = static_cast<uint16_t>(xMask | static_cast<uint16_t>(events[i].x()));
+			yMask = static_cast<uint16_t>(yMask | static_cast<uint16_t>(events[i].y()));
+		}
+
+		const uint32_t xBits = bitWidth(xMask);
+		const uint32_t yBits = bitWidth(yMask);
+
+		const int64_t firstTimestamp = (eventCount > 0) ? (events[0].timestamp()) : (0);
+
+		writeScalar<uint32_t>(out, static_cast<uint32_t>(eventCount));
+		out[4] = VERSION;
+		out[5] = static_cast<uint8_t>(xBits);
+		out[6] = static_cast<uint8_t>(yBits);
+		out[7] = 0;
+		writeScalar<int64_t>(out + 8, firstTimestamp);
+
+		const size_t blocks = getBlocksNumber(eventCount);
+
+		uint8_t *blockBits = out + HEADER_SIZE;
+		std::memset(blockBits, 0, getBlockBitsSize(blocks));
+
+		uint8_t *data = blockBits + getBlockBitsSize(blocks);
+
+		uint32_t deltasLow[BLOCK_SIZE];
+		uint32_t deltasHigh[BLOCK_SIZE];
+		uint32_t xs[BLOCK_SIZE];
+		uint32_t ys[BLOCK_SIZE];
+		uint32_t polarities[BLOCK_SIZE];
+
+		int64_t previousTimestamp = firstTimestamp;
+
+		for (size_t block = 0; block < blocks; block++) {
+			const size_t offset = block * BLOCK_SIZE;
+			const size_t length = std::min(BLOCK_SIZE, eventCount - offset);
+
+			// Gather fields into columns, padding the last block with zeros.
+			uint64_t deltaMask = 0;
+
+			for (size_t i = 0; i < length; i++) {
+				const Event &event = events[offset + i];
+
+				const uint64_t delta = zigZagEncode(event.timestamp() - previousTimestamp);
+				previousTimestamp    = event.timestamp();
+				deltaMask |= delta;
+
+				deltasLow[i]  = static_cast<uint32_t>(delta);
+				deltasHigh[i] = static_cast<uint32_t>(delta >> 32);
+				xs[i]         = static_cast<uint16_t>(event.x());
+				ys[i]         = static_cast<uint16_t>(event.y());
+				polarities[i] = event.polarity();
+			}
+
+			for (size_t i = length; i < BLOCK_SIZE; i++) {
+				deltasLow[i]  = 0;
+				deltasHigh[i] = 0;
+				xs[i]         = 0;
+				ys[i]         = 0;
+				polarities[i] = 0;
+			}
+
+			const uint32_t tsBits = bitWidth(deltaMask);
+			blockBits[block]      = static_cast<uint8_t>(tsBits);
+
+			data = packBlock(deltasLow, std::min(tsBits, 32U), data);
+			data = packBlock(deltasHigh, (tsBits > 32) ? (tsBits - 32) : (0), data);
+			data = packBlock(xs, xBits, data);
+			data = packBlock(ys, yBits, data);
+			data = packBlock(polarities, POLARITY_BIT, data);
+		}
+
+		return (static_cast<size_t>(data - out));
+	}
+
+	/**
+	 * Encode events, replacing the content of the output vector.
+	 *
+	 * @param events events to encode.
+	 * @param out output vector, resized to the encoded size.
+	 */
+	static void encode(const cvector<Event> &events, std::vector<uint8_t> &out) {
+		out.resize(encodedSizeBound(events.size()));
+		out.resize(encode(events.data(), events.size(), out.data()));
+	}
+
+	/**
+	 * Number of events contained in encoded data. The count is checked
+	 * against the smallest encoding it could have, so that it can be used
+	 * to allocate the output before decoding.
+	 *
+	 * @param in encoded data.
+	 * @param size size of encoded data in bytes.
+	 *
+	 * @return number of events.
+	 */
+	static size_t decodedEventCount(const uint8_t *in, size_t size) {
+		if (size < HEADER_SIZE) {
+			throw std::length_error("encoded events truncated.");
+		}
+
+		const size_t eventCount = readScalar<uint32_t>(in);
+
+		// Each block needs at least its width byte and its polarities, bounding the count by the size.
+		const size_t blocks = getBlocksNumber(eventCount);
+
+		if (size < (HEADER_SIZE + getBlockBitsSize(blocks) + (blocks * getPackedSize(POLARITY_BIT)))) {
+			throw std::length_error("encoded events truncated.");
+		}
+
+		return (eventCount);
+	}
+
+	/**
+	 * Decode events. The data is validated as it is decoded, malformed or
+	 * truncated input throws instead of reading out of bounds.
+	 *
+	 * @param in encoded data.
+	 * @param size size of encoded data in bytes.
+	 * @param events output, must hold at least decodedEventCount() events.
+	 */
+	static void decode(const uint8_t *in, size_t size, Event *events) {
+		const size_t eventCount = decodedEventCount(in, size);
+
+		const uint32_t xBits = in[5];
+		const uint32_t yBits = in[6];
+
+		if ((in[4] != VERSION) || (xBits > MAX_XY_BITS) || (yBits > MAX_XY_BITS)) {
+			throw std::invalid_argument("unsupported encoded events format.");
+		}
+
+		const int64_t firstTimestamp = readScalar<int64_t>(in + 8);
+
+		const size_t blocks = getBlocksNumber(eventCount);
+
+		const uint8_t *blockBits = in + HEADER_SIZE;
+		const uint8_t *data      = blockBits + getBlockBitsSize(blocks);
+		const uint8_t *end       = in + size;
+
+		uint32_t deltasLow[BLOCK_SIZE];
+		uint32_t deltasHigh[BLOCK_SIZE];
+		uint32_t xs[BLOCK_SIZE];
+		uint32_t ys[BLOCK_SIZE];
+		uint32_t polarities[BLOCK_SIZE];
+
+		int64_t timestamp = firstTimestamp;
+
+		for (size_t block = 0; block < blocks; block++) {
+			const uint32_t tsBits = blockBits[block];
+
+			if (tsBits > MAX_TS_BITS) {
+				throw std::invalid_argument("unsupported encoded events format.");
+			}
+
+			if (static_cast<size_t>(end - data) < getPackedSize(tsBits + xBits + yBits + POLARITY_BIT)) {
+				throw std::length_error("encoded events truncated.");
+			}
+
+			data = unpackBlock(data, std::min(tsBits, 32U), deltasLow);
+			data = unpackBlock(data, (tsBits > 32) ? (tsBits - 32) : (0), deltasHigh);
+			data = unpackBlock(data, xBits, xs);
+			data = unpackBlock(data, yBits, ys);
+			data = unpackBlock(data, POLARITY_BIT, polarities);
+
+			const size_t offset = block * BLOCK_SIZE;
+			const size_t length = std::min(BLOCK_SIZE, eventCount - offset);
+
+			for (size_t i = 0; i < length; i++) {
+				const uint64_t delta = (static_cast<uint64_t>(deltasHigh[i]) << 32) | deltasLow[i];
+
+				// Wrap instead of overflowing on malformed input.
+				timestamp = static_cast<int64_t>(static_cast<uint64_t>(timestamp) + zigZagDecode(delta));
+
+				events[offset + i] = Event(timestamp, static_cast<int16_t>(xs[i]), static_cast<int16_t>(ys[i]),
+					static_cast<bool>(polarities[i]));
+			}
+		}
+	}
+
+	/**
+	 * Decode events, replacing the content of the output vector.
+	 *
+	 * @param in encoded data.
+	 * @param size size of encoded data in bytes.
+	 * @param events output vector, resized to the number of events.
+	 */
+	static void decode(const uint8_t *in, size_t size, cvector<Event> &events) {
+		events.resize(decodedEventCount(in, size));
+		decode(in, size, events.data());
+	}
+
+private:
+	static size_t getBlocksNumber(size_t eventCount) {
+		return ((eventCount + BLOCK_SIZE - 1) / BLOCK_SIZE);
+	}
+
+	static size_t getBlockBitsSize(size_t blocks) {
+		return ((blocks + 3) & ~static_cast<size_t>(3));
+	}
+
+	static size_t getPackedSize(uint32_t bits) {
+		return (LANES * bits * sizeof(uint32_t));
+	}
+
+	template<typename T> static uint32_t bitWidth(T mask) {
+		uint32_t bits = 0;
+
+		while (mask != 0) {
+			mask = static_cast<T>(mask >> 1);
+			bits++;
+		}
+
+		return (bits);
+	}
+
+	static uint64_t zigZagEncode(int64_t value) {
+		return ((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	static uint64_t zigZagDecode(uint64_t value) {
+		return ((value >> 1) ^ (0 - (value & 1)));
+	}
+
+	template<typename T> static void writeScalar(uint8_t *out, T value) {
+		value = flatbuffers::EndianScalar(value);
+		std::memcpy(out, &value, sizeof(T));
+	}
+
+	template<typename T> static T readScalar(const uint8_t *in) {
+		T value;
+		std::memcpy(&value, in, sizeof(T));
+		return (flatbuffers::EndianScalar(value));
+	}
+
+	/**
+	 * Pack a block of values, each fitting in the given number of bits,
+	 * into LANES * bits words. All lanes use the same shift amounts.
+	 */
+	static uint8_t *packBlock(const uint32_t *values, uint32_t bits, uint8_t *out) {
+		if (bits == 0) {
+			return (out);
+		}
+
+		uint32_t words[LANES] = {0};
+		uint32_t shift        = 0;
+
+		for (size_t j = 0; j < (BLOCK_SIZE / LANES); j++) {
+			const uint32_t *value = values + (j * LANES);
+
+			for (size_t l = 0; l < LANES; l++) {
+				words[l] |= value[l] << shift;
+			}
+
+			shift += bits;
+
+			if (shift >= 32) {
+				for (size_t l = 0; l < LANES; l++) {
+					writeScalar<uint32_t>(out + (l * sizeof(uint32_t)), words[l]);
+				}
+
+				out += LANES * sizeof(uint32_t);
+				shift -= 32;
+
+				// Carry over the bits that did not fit.
+				for (size_t l = 0; l < LANES; l++) {
+					words[l] = (shift > 0) ? (value[l] >> (bits - shift)) : (0);
+				}
+			}
+		}
+
+		return (out);
+	}
+
+	/**
+	 * Unpack a block of values packed by packBlock(). Reads exactly
+	 * LANES * bits words.
+	 */
+	static const uint8_t *unpackBlock(const uint8_t *in, uint32_t bits, uint32_t *values) {
+		if (bits == 0) {
+			std::fill_n(values, BLOCK_SIZE, 0);
+			return (in);
+		}
+
+		const uint32_t mask = (bits == 32) ? (UINT32_MAX) : ((UINT32_C(1) << bits) - 1);
+
+		uint32_t words[LANES];
+		uint32_t shift = 0;
+
+		for (size_t l = 0; l < LANES; l++) {
+			words[l] = readScalar<uint32_t>(in + (l * sizeof(uint32_t)));
+		}
+
+		in += LANES * sizeof(uint32_t);
+
+		for (size_t j = 0; j < (BLOCK_SIZE / LANES); j++) {
+			uint32_t *value = values + (j * LANES);
+
+			for (size_t l = 0; l < LANES; l++) {
+				value[l] = words[l] >> shift;
+			}
+
+			shift += bits;
+
+			// The last value ends exactly at the end of the last word.
+			if ((shift >= 32) && (j < ((BLOCK_SIZE / LANES) - 1))) {
+				for (size_t l = 0; l < LANES; l++) {
+					words[l] = readScalar<uint32_t>(in + (l * sizeof(uint32_t)));
+				}
+
+				in += LANES * sizeof(uint32_t);
+				shift -= 32;
+
+				// Complete the values split across two words.
+				if (shift > 0) {
+					for (size_t l = 0; l < LANES; l++) {
+						value[l] |= words[l] << (bits - shift);
+					}
+				}
+			}
+
+			for (size_t l = 0; l < LANES; l++) {
+				value[l] &= mask;
+			}
+		}
+
+		return (in);
+	}
+};
+
+} // namespace dv
+
+#endif // DV_SDK_EVENT_CODEC_HPP
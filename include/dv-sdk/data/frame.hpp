@@ -172,6 +172,26 @@ public:
 		return (cv::Mat{ptr->sizeY, ptr->sizeX, static_cast<int>(ptr->format), ptr->pixels.data()});
 	}
 
+	/**
+	 * Sets the size and format of this frame, allocates its pixels and
+	 * returns an OpenCV Mat representing them. This allows rendering directly
+	 * into the output frame, instead of committing a separate Mat with
+	 * `commitMat`, which copies it. Call `commit` once done.
+	 * The same restrictions on the validity of the Mat as for `getMat` apply.
+	 *
+	 * @param sizeX The width of the frame
+	 * @param sizeY The height of the frame
+	 * @param format The pixel format of the frame
+	 * @return an OpenCV Mat of type CV_8UC(channels) backed by the frame pixels
+	 */
+	cv::Mat getMat(int16_t sizeX, int16_t sizeY, dv::FrameFormat format = dv::FrameFormat::GRAY) {
+		ptr->sizeX  = sizeX;
+		ptr->sizeY  = sizeY;
+		ptr->format = format;
+
+		return (getMat());
+	}
+
 	void commitMat(const cv::Mat &mat) {
 		ptr->sizeX = static_cast<int16_t>(mat.cols);
 		ptr->sizeY = static_cast<int16_t>(mat.rows);
@@ -19,6 +19,7 @@ typedef uint32_t (*dvTypePackFuncPtr)(void *toBuffer, const void *fromObject);
 typedef void (*dvTypeUnpackFuncPtr)(void *toObject, const void *fromBuffer);
 typedef void *(*dvTypeConstructPtr)(size_t sizeOfObject);
 typedef void (*dvTypeDestructPtr)(void *object);
+typedef bool (*dvTypeVerifyFuncPtr)(const void *fromBuffer, size_t bufferSize);
 
 struct dvType {
 	uint32_t id;
@@ -29,10 +30,18 @@ struct dvType {
 	dvTypeUnpackFuncPtr unpack;
 	dvTypeConstructPtr construct;
 	dvTypeDestructPtr destruct;
+	// Appended, so that the layout of the members above doesn't change. Optional.
+	dvTypeVerifyFuncPtr verify;
 
 #ifdef __cplusplus
 	constexpr dvType(const char *_identifier, const char *_description, size_t _sizeOfType, dvTypePackFuncPtr _pack,
 		dvTypeUnpackFuncPtr _unpack, dvTypeConstructPtr _construct, dvTypeDestructPtr _destruct) :
+		dvType(_identifier, _description, _sizeOfType, _pack, _unpack, _construct, _destruct, nullptr) {
+	}
+
+	constexpr dvType(const char *_identifier, const char *_description, size_t _sizeOfType, dvTypePackFuncPtr _pack,
+		dvTypeUnpackFuncPtr _unpack, dvTypeConstructPtr _construct, dvTypeDestructPtr _destruct,
+		dvTypeVerifyFuncPtr _verify) :
 		id(dvTypeIdentifierToId(_identifier)),
 		identifier(_identifier),
 		description(_description),
@@ -40,7 +49,8 @@ struct dvType {
 		pack(_pack),
 		unpack(_unpack),
 		construct(_construct),
-		destruct(_destruct) {
+		destruct(_destruct),
+		verify(_verify) {
 		if (identifier == nullptr) {
 			throw std::invalid_argument("Type identifier must be defined.");
 		}
@@ -57,7 +67,7 @@ struct dvType {
 
 	bool operator==(const dvType &rhs) const noexcept {
 		return ((id == rhs.id) && (sizeOfType == rhs.sizeOfType) && (pack == rhs.pack) && (unpack == rhs.unpack)
-				&& (construct == rhs.construct) && (destruct == rhs.destruct));
+				&& (construct == rhs.construct) && (destruct == rhs.destruct) && (verify == rhs.verify));
 	}
 
 	bool operator!=(const dvType &rhs) const noexcept {
@@ -123,6 +133,7 @@ using PackFuncPtr   = dvTypePackFuncPtr;
 using UnpackFuncPtr = dvTypeUnpackFuncPtr;
 using ConstructPtr  = dvTypeConstructPtr;
 using DestructPtr   = dvTypeDestructPtr;
+using VerifyFuncPtr = dvTypeVerifyFuncPtr;
 
 template<typename FBType> constexpr static uint32_t Packer(void *toBuffer, const void *fromObject) {
 	using ObjectAPIType = typename FBType::NativeTableType;
@@ -137,6 +148,16 @@ template<typename FBType> constexpr static void Unpacker(void *toObject, const v
 	FBType::UnPackToFrom(static_cast<ObjectAPIType *>(toObject), static_cast<const FBType *>(fromBuffer), nullptr);
 }
 
+/**
+ * Check a size-prefixed flatbuffer of untrusted origin, so that it can be
+ * unpacked safely: all offsets and sizes must stay within the buffer.
+ */
+template<typename FBType> constexpr static bool Verifier(const void *fromBuffer, size_t bufferSize) {
+	flatbuffers::Verifier verifier(static_cast<const uint8_t *>(fromBuffer), bufferSize);
+
+	return (verifier.VerifySizePrefixedBuffer<FBType>(FBType::identifier));
+}
+
 template<typename FBType> constexpr static void *Constructor(size_t sizeOfObject) {
 	using ObjectAPIType = typename FBType::NativeTableType;
 
@@ -168,7 +189,7 @@ template<typename FBType> constexpr static Type makeTypeDefinition(const char *d
 	static_assert(std::is_standard_layout_v<ObjectAPIType>, "ObjectAPIType is not standard layout");
 
 	return (Type{FBType::identifier, description, sizeof(ObjectAPIType), &Packer<FBType>, &Unpacker<FBType>,
-		&Constructor<FBType>, &Destructor<FBType>});
+		&Constructor<FBType>, &Destructor<FBType>, &Verifier<FBType>});
 }
 
 } // namespace dv::Types
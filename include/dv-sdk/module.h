@@ -66,6 +66,9 @@ dvConfigNode dvModuleOutputGetInfoNode(dvModuleData moduleData, const char *name
 dvConfigNodeConst dvModuleInputGetInfoNode(dvModuleData moduleData, const char *name);
 bool dvModuleInputIsConnected(dvModuleData moduleData, const char *name);
 
+// Functions available for use: run control.
+void dvModuleRunTimeoutSet(dvModuleData moduleData, int64_t timeoutMicroseconds);
+
 #ifdef __cplusplus
 }
 #endif
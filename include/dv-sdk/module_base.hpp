@@ -7,6 +7,7 @@
 #include "module_io.hpp"
 #include "utils.h"
 
+#include <chrono>
 #include <utility>
 
 namespace dv {
@@ -147,6 +148,19 @@ public:
 	virtual void configUpdate() {
 	}
 
+	/**
+	 * Sets the maximum time between two calls to `run()`. If no new input
+	 * data arrives within that time, `run()` is called anyway, with no data
+	 * available on any input. This allows modules to act on the passage of
+	 * time alone, for example to keep producing output while the input is
+	 * quiet. Modules without inputs always run and are not affected.
+	 * @param timeout The maximum time between calls to `run()`. Zero to
+	 * only run on new input data, which is the default.
+	 */
+	void setRunTimeout(std::chrono::microseconds timeout) {
+		dvModuleRunTimeoutSet(moduleData, timeout.count());
+	}
+
 	/**
 	 * Virtual function to be implemented by the user.
 	 * Main function that runs the module and handles data.
@@ -4,8 +4,11 @@
 #include "../data/event.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <opencv2/opencv.hpp>
 #include <vector>
 
@@ -72,6 +75,8 @@ public:
 		referencesConstData_(false),
 		start_(0),
 		length_(0),
+		lowestTime_(0),
+		highestTime_(0),
 		data_(std::make_shared<const dv::EventPacketT>()) {
 	}
 
@@ -127,6 +132,16 @@ public:
 		return data_->events.begin() + start_;
 	}
 
+	/**
+	 * Returns a pointer to the first element of the `PartialEventData`.
+	 * The elements of the current slice are stored contiguously, so
+	 * `data()` to `data() + getLength()` can be iterated as a plain array.
+	 * @return A pointer to the first event of the slice
+	 */
+	inline const Event *data() const {
+		return data_->events.data() + start_;
+	}
+
 	/**
 	 * Returns an iterator to one after the last element of the `PartialEventData`.
 	 * The iterator is according to the current slice and not to the
@@ -153,9 +168,11 @@ public:
 			throw std::range_error("Can not slice more than length from PartialEventData.");
 		}
 
-		start_      = start_ + number;
-		length_     = length_ - number;
-		lowestTime_ = (data_->events)[start_].timestamp();
+		start_  = start_ + number;
+		length_ = length_ - number;
+		if (length_ > 0) {
+			lowestTime_ = (data_->events)[start_].timestamp();
+		}
 	}
 
 	/**
@@ -173,8 +190,10 @@ public:
 			throw std::range_error("Can not slice more than length from PartialEventData.");
 		}
 
-		length_      = length_ - number;
-		highestTime_ = (data_->events)[start_ + length_ - 1].timestamp();
+		length_ = length_ - number;
+		if (length_ > 0) {
+			highestTime_ = (data_->events)[start_ + length_ - 1].timestamp();
+		}
 	}
 
 	/**
@@ -244,7 +263,7 @@ public:
 			lowestTime_ = event.timestamp();
 		}
 		const dv::cvector<dv::Event> &constVectorRef = data_->events;
-		auto vectorRef                               = const_cast<dv::cvector<dv::Event> &>(constVectorRef);
+		auto &vectorRef                              = const_cast<dv::cvector<dv::Event> &>(constVectorRef);
 		vectorRef.emplace_back(event);
 		length_++;
 	}
@@ -315,6 +334,31 @@ public:
 	}
 };
 
+/**
+ * __INTERNAL USE ONLY__
+ * Compact time bounds of a single `PartialEventData` shard. The `EventStore`
+ * keeps these in a contiguous index next to its shards, so that time based
+ * lookups can binary search a small, cache friendly array instead of touching
+ * the (much larger) shard control structures.
+ */
+struct PartialEventDataTimeBounds {
+	time_t lowestTime;
+	time_t highestTime;
+
+	explicit PartialEventDataTimeBounds(const PartialEventData &partial) :
+		lowestTime(partial.getLowestTime()),
+		highestTime(partial.getHighestTime()) {
+	}
+
+	inline time_t getLowestTime() const {
+		return lowestTime;
+	}
+
+	inline time_t getHighestTime() const {
+		return highestTime;
+	}
+};
+
 /**
  * __INTERNAL USE ONLY__
  * Comparator Functor that checks if a given time lies within bounds of the event packet
@@ -350,6 +394,26 @@ public:
 	bool operator()(const time_t time, const PartialEventData &partial) const {
 		return lower_ ? time < partial.getLowestTime() : time < partial.getHighestTime();
 	}
+
+	/**
+	 * Same as the `PartialEventData` overload, but operates on the compact time index.
+	 * @param bounds The time bounds of the partial to be analysed
+	 * @param time The time to be compared against
+	 * @return true, if time is higher than either lowest or highest timestamp of the bounds depending on state
+	 */
+	bool operator()(const PartialEventDataTimeBounds &bounds, const time_t time) const {
+		return lower_ ? bounds.getLowestTime() < time : bounds.getHighestTime() < time;
+	}
+
+	/**
+	 * Same as the `PartialEventData` overload, but operates on the compact time index.
+	 * @param time The time to be compared against
+	 * @param bounds The time bounds of the partial to be analysed
+	 * @return true, if time is lower than either lowest or highest timestamp of the bounds depending on state
+	 */
+	bool operator()(const time_t time, const PartialEventDataTimeBounds &bounds) const {
+		return lower_ ? time < bounds.getLowestTime() : time < bounds.getHighestTime();
+	}
 };
 
 /**
@@ -537,6 +601,29 @@ public:
 	}
 };
 
+/**
+ * __INTERNAL USE ONLY__
+ * Adapter that runs a function for every index of a range through OpenCV's
+ * parallel framework. Used to distribute independent work items, such as the
+ * shards of an `EventStore` or the jobs of an `EventStreamSlicer`, over
+ * OpenCV's thread pool.
+ * @tparam Function Callable with signature `void(size_t)`
+ */
+template<class Function> class ParallelIndexLoopBody : public cv::ParallelLoopBody {
+private:
+	Function &function_;
+
+public:
+	explicit ParallelIndexLoopBody(Function &function) : function_(function) {
+	}
+
+	void operator()(const cv::Range &range) const override {
+		for (int i = range.start; i < range.end; i++) {
+			function_(static_cast<size_t>(i));
+		}
+	}
+};
+
 /**
  * EventStore class.
  * An `EventStore` is a collection of consecutive events, all monotonically
@@ -555,6 +642,8 @@ protected:
 	std::vector<PartialEventData> dataPartials_;
 	/** The exact number-of-events global offsets of the shards */
 	std::vector<size_t> partialOffsets_;
+	/** Compact index of the lowest and highest timestamps of the shards */
+	std::vector<PartialEventDataTimeBounds> partialTimes_;
 	/** The total length of the event package */
 	size_t totalLength_ = 0;
 
@@ -568,16 +657,42 @@ protected:
 	 * package from.
 	 */
 	explicit EventStore(std::vector<PartialEventData> &dataPartials) {
-		this->dataPartials_ = dataPartials;
+		dataPartials_.reserve(dataPartials.size());
+		partialOffsets_.reserve(dataPartials.size());
+		partialTimes_.reserve(dataPartials.size());
 
-		// Build up length and offsets
+		// Build up length, offsets and time index
 		totalLength_ = 0;
 		for (const auto &partial : dataPartials) {
-			partialOffsets_.emplace_back(totalLength_);
-			totalLength_ += partial.getLength();
+			addPartial(partial);
 		}
 	}
 
+	/**
+	 * __INTERNAL USE ONLY__
+	 * Appends a shard to the end of the store and updates offsets, time index
+	 * and total length accordingly. The shard must not contain events that are
+	 * older than the current highest time of the store.
+	 * @param partial The shard to append.
+	 */
+	void addPartial(const PartialEventData &partial) {
+		dataPartials_.push_back(partial);
+		partialOffsets_.push_back(totalLength_);
+		partialTimes_.emplace_back(partial);
+		totalLength_ += partial.getLength();
+	}
+
+	/**
+	 * __INTERNAL USE ONLY__
+	 * Returns the global offset (in number of events) of the shard at the given
+	 * index. An index one past the last shard returns the total length.
+	 * @param partialIndex The index of the shard
+	 * @return The number of events that precede the shard in the store
+	 */
+	inline size_t partialOffset(size_t partialIndex) const {
+		return (partialIndex < partialOffsets_.size()) ? partialOffsets_[partialIndex] : totalLength_;
+	}
+
 public:
 	/**
 	 * Default constructor.
@@ -602,14 +717,12 @@ public:
 	 * @param packet the packet to use to
 	 */
 	void addEventPacket(const dv::InputDataWrapper<dv::EventPacket> &packet) {
-		if (!dataPartials_.empty() && dataPartials_.back().getHighestTime() > packet.front().timestamp()) {
+		if (!partialTimes_.empty() && partialTimes_.back().getHighestTime() > packet.front().timestamp()) {
 			std::cerr << "[WARNING] Tried adding event packet to store out of order. Ignoring packet." << std::endl;
 			return;
 		}
 
-		dataPartials_.emplace_back(PartialEventData(packet.getBasePointer()));
-		partialOffsets_.emplace_back(totalLength_);
-		totalLength_ += dataPartials_.back().getLength();
+		addPartial(PartialEventData(packet.getBasePointer()));
 	}
 
 	/**
@@ -623,10 +736,8 @@ public:
 			return;
 		}
 
-		for (PartialEventData &partial : store.dataPartials_) {
-			dataPartials_.push_back(partial);
-			partialOffsets_.push_back(totalLength_);
-			totalLength_ += partial.getLength();
+		for (const PartialEventData &partial : store.dataPartials_) {
+			addPartial(partial);
 		}
 	}
 
@@ -659,17 +770,16 @@ public:
 				return;
 			}
 			if (!targetPartial->canStoreMoreEvents()) {
-				dataPartials_.emplace_back(PartialEventData());
-				partialOffsets_.emplace_back(totalLength_);
+				addPartial(PartialEventData());
 				targetPartial = &dataPartials_.back();
 			}
 		}
 		else {
-			dataPartials_.emplace_back(PartialEventData());
-			partialOffsets_.emplace_back(totalLength_);
+			addPartial(PartialEventData());
 			targetPartial = &dataPartials_.back();
 		}
 		targetPartial->unsafe_addEvent(event);
+		partialTimes_.back() = PartialEventDataTimeBounds(*targetPartial);
 		this->totalLength_++;
 	}
 
@@ -775,27 +885,27 @@ public:
 	 * to the sliced, shared data. No data is copied over.
 	 */
 	EventStore sliceTime(time_t startTime, time_t endTime, size_t &retStart, size_t &retEnd) const {
-		// we find the relevant partials and slice the first and last one to fit
-		std::vector<PartialEventData> newPartials;
-
+		// we find the relevant partials through the time index and slice the first and last one to fit
 		auto lowerPartial = std::lower_bound(
-			dataPartials_.begin(), dataPartials_.end(), startTime, PartialEventDataTimeComparator(false));
+			partialTimes_.begin(), partialTimes_.end(), startTime, PartialEventDataTimeComparator(false));
 		auto upperPartial = std::lower_bound(
-			dataPartials_.begin(), dataPartials_.end(), endTime, PartialEventDataTimeComparator(true));
+			lowerPartial, partialTimes_.end(), endTime, PartialEventDataTimeComparator(true));
+		auto lowIndex  = static_cast<size_t>(lowerPartial - partialTimes_.begin());
+		auto highIndex = static_cast<size_t>(upperPartial - partialTimes_.begin());
 
-		size_t newLength = 0;
-		for (auto it = lowerPartial; it < upperPartial; it++) {
-			newLength += it->getLength();
-			newPartials.emplace_back(*it);
-		}
+		size_t newLength = (lowIndex < highIndex) ? (partialOffset(highIndex) - partialOffset(lowIndex)) : 0;
 
 		if (newLength == 0) {
-			retStart = isEmpty() ? 0 : partialOffsets_[static_cast<size_t>(lowerPartial - dataPartials_.begin())];
+			retStart = isEmpty() ? 0 : partialOffset(lowIndex);
 			retEnd   = retStart;
 
 			return EventStore();
 		}
 
+		std::vector<PartialEventData> newPartials(
+			dataPartials_.begin() + static_cast<ptrdiff_t>(lowIndex),
+			dataPartials_.begin() + static_cast<ptrdiff_t>(highIndex));
+
 		size_t cutFront = newPartials.front().sliceTimeFront(startTime);
 		size_t cutBack  = newPartials.back().sliceTimeBack(endTime);
 		newLength       = newLength - cutFront - cutBack;
@@ -808,7 +918,7 @@ public:
 			newPartials.erase(newPartials.end() - 1);
 		}
 
-		retStart = partialOffsets_[static_cast<size_t>(lowerPartial - dataPartials_.begin())] + cutFront;
+		retStart = partialOffset(lowIndex) + cutFront;
 		retEnd   = retStart + newLength;
 
 		return EventStore(newPartials);
@@ -876,6 +986,86 @@ public:
 		return (iterator(&dataPartials_, false));
 	}
 
+	/**
+	 * Calls the supplied function for every contiguous chunk of events in
+	 * the store, in order. Each shard of the store is one chunk, handed over
+	 * as a `[begin, end)` pointer range. Iterating a chunk is a plain pointer
+	 * loop, without the per-event shard bookkeeping of `EventStoreIterator`.
+	 * Empty shards are skipped.
+	 * @tparam Function Callable with signature `void(const Event *, const Event *)`
+	 * @param function The function to be called for every chunk
+	 */
+	template<class Function> void forEachChunk(Function &&function) const {
+		for (const auto &partial : dataPartials_) {
+			if (partial.getLength() == 0) {
+				continue;
+			}
+
+			function(partial.data(), partial.data() + partial.getLength());
+		}
+	}
+
+	/**
+	 * Calls the supplied function for every contiguous chunk of events in the
+	 * store, distributing the chunks over OpenCV's thread pool. Chunks are
+	 * disjoint, but no order between them is guaranteed, so the function must
+	 * only write to state that is private to the chunk (or synchronized).
+	 * Use `parallelReduceChunks` to combine per-chunk results.
+	 * @tparam Function Callable with signature `void(const Event *, const Event *)`
+	 * @param function The function to be called for every chunk
+	 */
+	template<class Function> void parallelForEachChunk(Function &&function) const {
+		auto chunkFunction = [this, &function](size_t index) {
+			const auto &partial = dataPartials_[index];
+			if (partial.getLength() > 0) {
+				function(partial.data(), partial.data() + partial.getLength());
+			}
+		};
+
+		cv::parallel_for_(cv::Range(0, static_cast<int>(dataPartials_.size())),
+			ParallelIndexLoopBody<decltype(chunkFunction)>(chunkFunction));
+	}
+
+	/**
+	 * Computes a result for every contiguous chunk of events in parallel and
+	 * combines the results. The `map` function is distributed over OpenCV's
+	 * thread pool, one call per chunk. The `reduce` function is then called
+	 * serially on the calling thread, in chunk order, so the result is
+	 * deterministic even for non-commutative reductions.
+	 * @tparam T The type of the result
+	 * @tparam MapFunction Callable with signature `T(const Event *, const Event *)`
+	 * @tparam ReduceFunction Callable with signature `T(const T &, const T &)`
+	 * @param init The initial value of the reduction, returned for an empty store
+	 * @param map The function computing the result of a single chunk
+	 * @param reduce The function combining the accumulated result with the result of a chunk
+	 * @return The reduction of all chunk results
+	 */
+	template<typename T, class MapFunction, class ReduceFunction>
+	T parallelReduceChunks(T init, MapFunction &&map, ReduceFunction &&reduce) const {
+		std::vector<T> chunkResults(dataPartials_.size(), init);
+		std::vector<char> chunkValid(dataPartials_.size(), false);
+
+		auto chunkFunction = [this, &map, &chunkResults, &chunkValid](size_t index) {
+			const auto &partial = dataPartials_[index];
+			if (partial.getLength() > 0) {
+				chunkResults[index] = map(partial.data(), partial.data() + partial.getLength());
+				chunkValid[index]   = true;
+			}
+		};
+
+		cv::parallel_for_(cv::Range(0, static_cast<int>(dataPartials_.size())),
+			ParallelIndexLoopBody<decltype(chunkFunction)>(chunkFunction));
+
+		T result = init;
+		for (size_t i = 0; i < chunkResults.size(); i++) {
+			if (chunkValid[i]) {
+				result = reduce(result, chunkResults[i]);
+			}
+		}
+
+		return result;
+	}
+
 	/**
 	 * Returns a reference to the first element of the packet
 	 * @return a reference to the first element to the packet
@@ -905,7 +1095,7 @@ public:
 		if (isEmpty()) {
 			return 0;
 		}
-		return dataPartials_.front().getLowestTime();
+		return partialTimes_.front().getLowestTime();
 	}
 
 	/**
@@ -919,7 +1109,7 @@ public:
 		if (isEmpty()) {
 			return 0;
 		}
-		return dataPartials_.back().getHighestTime();
+		return partialTimes_.back().getHighestTime();
 	}
 
 	/**
@@ -939,82 +1129,279 @@ public:
 	}
 };
 
+/**
+ * __INTERNAL USE ONLY__
+ * Processes the events of an `EventStore` concurrently, split by location.
+ * The rows of the sensor are divided into horizontal tiles of equal height.
+ * In a single pass over the store, the events are binned into their tiles,
+ * keeping their order. The tiles are then processed concurrently, each one
+ * by a single thread, in event order. As every pixel belongs to exactly one
+ * tile, all events of a pixel are still processed in their original order,
+ * so per-pixel state ends up bit-identical to a serial loop.
+ * The binning buffers are kept between calls to avoid reallocations.
+ */
+class RowTileScheduler {
+private:
+	std::vector<const Event *> binnedEvents_;
+	std::vector<size_t> tileOffsets_;
+	std::vector<size_t> tileInsert_;
+
+public:
+	/**
+	 * Calls the supplied function for every event in the store, processing
+	 * the tiles concurrently on OpenCV's thread pool.
+	 * @tparam Function Callable with signature `void(const Event &)`. It is
+	 * called concurrently for events of different tiles and must therefore
+	 * only modify state belonging to the pixel of the event.
+	 * @param store The events to process
+	 * @param rows The number of rows of the sensor. All events must lie within.
+	 * @param tiles The number of tiles, which is also the maximum number of
+	 * threads used. 0 to use as many as OpenCV has threads.
+	 * @param function The function to be called for every event
+	 */
+	template<class Function> void forEachEvent(const EventStore &store, int rows, int tiles, Function &&function) {
+		if (tiles <= 0) {
+			tiles = cv::getNumThreads();
+		}
+		tiles = std::max(1, std::min(tiles, rows));
+
+		if (tiles == 1) {
+			store.forEachChunk([&function](const Event *begin, const Event *end) {
+				for (const Event *event = begin; event < end; event++) {
+					function(*event);
+				}
+			});
+			return;
+		}
+
+		const auto tileOf = [rows, tiles](const Event *event) {
+			return static_cast<size_t>(event->y() * tiles / rows);
+		};
+
+		// count events per tile, offsets are shifted by one for the prefix sum
+		tileOffsets_.assign(static_cast<size_t>(tiles) + 1, 0);
+		store.forEachChunk([this, &tileOf](const Event *begin, const Event *end) {
+			for (const Event *event = begin; event < end; event++) {
+				tileOffsets_[tileOf(event) + 1]++;
+			}
+		});
+		std::partial_sum(tileOffsets_.begin(), tileOffsets_.end(), tileOffsets_.begin());
+
+		// bin events into their tiles, in order
+		binnedEvents_.resize(store.getTotalLength());
+		tileInsert_.assign(tileOffsets_.begin(), tileOffsets_.end() - 1);
+		store.forEachChunk([this, &tileOf](const Event *begin, const Event *end) {
+			for (const Event *event = begin; event < end; event++) {
+				binnedEvents_[tileInsert_[tileOf(event)]++] = event;
+			}
+		});
+
+		auto tileFunction = [this, &function](size_t tile) {
+			for (size_t i = tileOffsets_[tile]; i < tileOffsets_[tile + 1]; i++) {
+				function(*binnedEvents_[i]);
+			}
+		};
+
+		// one stripe per tile, so that every tile is processed by a single thread
+		cv::parallel_for_(cv::Range(0, tiles), ParallelIndexLoopBody<decltype(tileFunction)>(tileFunction),
+			static_cast<double>(tiles));
+	}
+};
+
 /**
  * The EventStreamSlicer is a class that takes on incoming events, stores
  * them in a minimal way and invokes functions at individual
  * periods.
  */
 class EventStreamSlicer {
+public:
+	/**
+	 * Execution policy of the slice jobs.
+	 *
+	 * * `SEQUENTIAL`: All jobs run one after the other on the calling thread.
+	 *
+	 * * `PARALLEL`: Jobs run concurrently on OpenCV's thread pool. Each job
+	 *    still receives its slices in order, on one thread at a time. Callbacks
+	 *    of different jobs may run at the same time, so they must not share
+	 *    state without synchronization.
+	 */
+	enum ExecutionPolicy { SEQUENTIAL = 0, PARALLEL = 1 };
+
+private:
 	/**
 	 * __INTERNAL USE ONLY__
 	 * A single job of the EventStreamSlicer
 	 */
 	class SliceJob {
 	public:
-		enum SliceType { NUMBER, TIME };
+		enum SliceType { NUMBER, TIME, CLOCK };
 
 	private:
 		SliceType type_;
 		const std::function<void(EventStore &)> callback_;
 		time_t timeInterval_;
 		size_t numberInterval_;
-		time_t lastCallEndTime_;
+		time_t timeWindow_;
+		size_t numberWindow_;
+		time_t nextCallStartTime_;
+		/** Wall-clock interval of CLOCK jobs, in µs */
+		time_t clockInterval_ = 0;
+		/** Wall-clock time in µs after which a NUMBER or TIME job flushes its partial window, 0 to disable */
+		time_t clockTimeout_ = 0;
+		std::chrono::steady_clock::time_point lastCallClock_;
+		/** Set after a timeout flush, restarts the time windows at the next new event */
+		bool resyncTime_ = false;
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Executes the callback and remembers when it happened.
+		 */
+		inline void call(EventStore &slice, const std::chrono::steady_clock::time_point now) {
+			lastCallClock_ = now;
+			callback_(slice);
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Hands all events that were not passed to the callback yet to it, as
+		 * a partial window, and restarts the windows after them.
+		 * @param packet the storage packet to slice on.
+		 * @param now the current wall-clock time
+		 */
+		void flush(EventStore &packet, const std::chrono::steady_clock::time_point now) {
+			EventStore slice;
+
+			if (type_ == TIME && nextCallStartTime_ != 0) {
+				if (!packet.isEmpty() && packet.getHighestTime() >= nextCallStartTime_) {
+					size_t sliceStart, sliceEnd;
+					slice = packet.sliceTime(
+						nextCallStartTime_, packet.getHighestTime() + 1, sliceStart, sliceEnd);
+					nextCallStartTime_ = packet.getHighestTime() + 1;
+				}
+				nextCallStart = packet.getTotalLength();
+				resyncTime_   = true;
+			}
+			else if (nextCallStart < packet.getTotalLength()) {
+				slice         = packet.slice(nextCallStart);
+				nextCallStart = packet.getTotalLength();
+			}
+
+			call(slice, now);
+		}
 
 	public:
-		size_t lastCallEnd;
+		/** Index of the first event in the store the next call still needs. */
+		size_t nextCallStart;
 
 		/**
 		 * __INTERNAL USE ONLY__
 		 * Creates a new SliceJob of a certain type, interval and callback
 		 * @param type The type of periodicity. Can be either NUMBER or TIME
-		 * @param interval The interval (either in time or number) at which
-		 * the job should be executed
+		 * @param timeInterval The time interval at which the job should be executed
+		 * @param numberInterval The number interval at which the job should be executed
+		 * @param timeWindow The length in time of the data handed to the callback.
+		 * 0 to use back-to-back windows of length `timeInterval`.
+		 * @param numberWindow The length in number of events of the data handed to
+		 * the callback. 0 to use back-to-back windows of length `numberInterval`.
 		 * @param callback The callback function to call on execution.
 		 */
 		SliceJob(const SliceType type, const time_t timeInterval, const size_t numberInterval,
-			std::function<void(EventStore &)> callback) :
+			const time_t timeWindow, const size_t numberWindow, std::function<void(EventStore &)> callback) :
 			type_(type),
 			callback_(std::move(callback)),
 			timeInterval_(timeInterval),
 			numberInterval_(numberInterval),
-			lastCallEndTime_(0),
-			lastCallEnd(0) {
+			timeWindow_(timeWindow),
+			numberWindow_(numberWindow),
+			nextCallStartTime_(0),
+			nextCallStart(0) {
 		}
 
 		SliceJob() = default;
 
+		/**
+		 * __INTERNAL USE ONLY__
+		 * @return The length in time of the windows passed to the callback
+		 */
+		inline time_t getTimeWindow() const {
+			return (timeWindow_ > 0) ? timeWindow_ : timeInterval_;
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * @return The length in number of events of the windows passed to the callback
+		 */
+		inline size_t getNumberWindow() const {
+			return (numberWindow_ > 0) ? numberWindow_ : numberInterval_;
+		}
+
 		/**
 		 * __INTERNAL USE ONLY__
 		 * This function establishes how much fresh data is availble
 		 * and how often the callback can be executed on this fresh data.
 		 * it then creates slices of the data and executes the callback as
-		 * often as possible.
+		 * often as possible. Windows start every interval and span the
+		 * window length, so they may overlap (window > interval), be
+		 * back-to-back (window == interval) or skip data (window < interval).
+		 * Afterwards, `nextCallStart` points to the first event that is
+		 * still needed by the next, not yet complete, window.
+		 * CLOCK jobs instead get all new events once their wall-clock
+		 * interval has passed. NUMBER and TIME jobs with a clock timeout
+		 * get their incomplete window if the callback was not called for
+		 * that long.
 		 * @param packet the storage packet to slice on.
+		 * @param now the current wall-clock time
 		 */
-		void run(EventStore &packet) {
-			if (packet.getTotalLength() == 0) {
+		void run(EventStore &packet, const std::chrono::steady_clock::time_point now) {
+			if (lastCallClock_ == std::chrono::steady_clock::time_point()) { // initialize with the first run
+				lastCallClock_ = now;
+			}
+
+			if (type_ == CLOCK) {
+				if (now - lastCallClock_ >= std::chrono::microseconds(clockInterval_)) {
+					flush(packet, now);
+				}
 				return;
 			}
 
-			if (type_ == NUMBER) {
-				while (packet.getTotalLength() - lastCallEnd >= numberInterval_) {
-					EventStore slice = packet.slice(lastCallEnd, numberInterval_);
-					lastCallEnd      = lastCallEnd + numberInterval_;
-					callback_(slice);
+			if (type_ == NUMBER && !packet.isEmpty()) {
+				const size_t window = getNumberWindow();
+
+				while (packet.getTotalLength() >= nextCallStart + window) {
+					EventStore slice = packet.slice(nextCallStart, window);
+					nextCallStart    = nextCallStart + numberInterval_;
+					call(slice, now);
 				}
 			}
 
-			if (type_ == TIME) {
-				if (lastCallEndTime_ == 0) { // initialize with the lowest time
-					lastCallEndTime_ = packet.getLowestTime();
+			if (type_ == TIME && !packet.isEmpty()) {
+				const time_t window = getTimeWindow();
+
+				if (nextCallStartTime_ == 0) { // initialize with the lowest time
+					nextCallStartTime_ = packet.getLowestTime();
+				}
+				if (resyncTime_ && packet.getHighestTime() >= nextCallStartTime_) {
+					// the quiet period was already covered by timeout flushes,
+					// restart at the first new event instead of catching up
+					// with empty windows
+					nextCallStartTime_
+						= packet.sliceTime(nextCallStartTime_, packet.getHighestTime() + 1).getLowestTime();
+					resyncTime_ = false;
 				}
-				while (packet.getHighestTime() - lastCallEndTime_ >= timeInterval_) {
-					size_t lastCallStart;
-					EventStore slice = packet.sliceTime(
-						lastCallEndTime_, lastCallEndTime_ + timeInterval_, lastCallStart, lastCallEnd);
-					lastCallEndTime_ = lastCallEndTime_ + timeInterval_;
-					callback_(slice);
+				while (packet.getHighestTime() - nextCallStartTime_ >= window) {
+					EventStore slice   = packet.sliceTime(nextCallStartTime_, nextCallStartTime_ + window);
+					nextCallStartTime_ = nextCallStartTime_ + timeInterval_;
+					call(slice, now);
 				}
+
+				// Find the first event of the next window. If there is none yet,
+				// all events currently in the store can be discarded.
+				size_t nextCallEnd;
+				packet.sliceTime(nextCallStartTime_, packet.getHighestTime() + 1, nextCallStart, nextCallEnd);
+			}
+
+			if (clockTimeout_ > 0 && now - lastCallClock_ >= std::chrono::microseconds(clockTimeout_)) {
+				flush(packet, now);
 			}
 		}
 
@@ -1035,7 +1422,47 @@ class EventStreamSlicer {
 		 */
 		void setNumberInterval(size_t numberInterval) {
 			assert(type_ == NUMBER);
-			numberInterval = numberInterval_;
+			numberInterval_ = numberInterval;
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Sets the time window to the supplied value
+		 * @param timeWindow the new time window to use, 0 for back-to-back windows
+		 */
+		void setTimeWindow(time_t timeWindow) {
+			assert(type_ == TIME);
+			timeWindow_ = timeWindow;
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Sets the number window to the supplied value
+		 * @param numberWindow the new number window to use, 0 for back-to-back windows
+		 */
+		void setNumberWindow(size_t numberWindow) {
+			assert(type_ == NUMBER);
+			numberWindow_ = numberWindow;
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Sets the wall-clock interval to the supplied value
+		 * @param clockInterval the new wall-clock interval to use, in µs
+		 */
+		void setClockInterval(time_t clockInterval) {
+			assert(type_ == CLOCK);
+			clockInterval_ = clockInterval;
+		}
+
+		/**
+		 * __INTERNAL USE ONLY__
+		 * Sets the wall-clock timeout to the supplied value
+		 * @param clockTimeout the new wall-clock timeout to use, in µs, 0 to disable
+		 */
+		void setClockTimeout(time_t clockTimeout) {
+			assert(type_ != CLOCK);
+			clockTimeout_ = clockTimeout;
 		}
 	};
 
@@ -1048,34 +1475,108 @@ private:
 	std::map<slicejob_t, SliceJob> sliceJobs_;
 	slicejob_t hashCounter_ = 0;
 
+	/** How the jobs are executed on new data */
+	ExecutionPolicy executionPolicy_ = SEQUENTIAL;
+
+	/**
+	 * __INTERNAL USE ONLY__
+	 * Runs all jobs concurrently on the current store. The store is only read
+	 * while the jobs run. Returns once all jobs have completed. If any job
+	 * threw an exception, the first one (in job order) is rethrown.
+	 */
+	void runJobsParallel() {
+		std::vector<SliceJob *> jobs;
+		jobs.reserve(sliceJobs_.size());
+		for (auto &jobTuple : sliceJobs_) {
+			jobs.push_back(&jobTuple.second);
+		}
+
+		std::vector<std::exception_ptr> jobErrors(jobs.size());
+
+		const auto now = std::chrono::steady_clock::now();
+
+		auto jobFunction = [this, &jobs, &jobErrors, now](size_t index) {
+			try {
+				jobs[index]->run(storePacket_, now);
+			}
+			catch (...) {
+				jobErrors[index] = std::current_exception();
+			}
+		};
+
+		// one stripe per job, so that every job can be picked up by a different thread
+		cv::parallel_for_(cv::Range(0, static_cast<int>(jobs.size())),
+			ParallelIndexLoopBody<decltype(jobFunction)>(jobFunction), static_cast<double>(jobs.size()));
+
+		for (const auto &error : jobErrors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+public:
 	/**
-	 * Should get called as soon as there is fresh data available.
+	 * Gets called automatically as soon as there is fresh data available.
 	 * It loops through all jobs and determines if they can run on the new data.
-	 * The jobs get executed as often as possible. Afterwards, all data that has
-	 * been processed by all jobs gets discarded.
+	 * The jobs get executed as often as possible. Afterwards, all data that is
+	 * not needed anymore by any job gets discarded.
+	 * Call it manually, without new data, to let wall-clock driven jobs and
+	 * timeouts fire while the event stream is quiet, for example from a
+	 * module's `run()` that was invoked by its run timeout.
 	 */
 	void evaluate() {
 		// run jobs
-		for (auto &jobTuple : sliceJobs_) {
-			jobTuple.second.run(storePacket_);
+		if (executionPolicy_ == PARALLEL && sliceJobs_.size() > 1) {
+			runJobsParallel();
+		}
+		else {
+			const auto now = std::chrono::steady_clock::now();
+
+			for (auto &jobTuple : sliceJobs_) {
+				jobTuple.second.run(storePacket_, now);
+			}
 		}
 
-		// find  border of the end of last call
+		// find the first event that is still needed by any job
 		size_t lowerBound = storePacket_.getTotalLength();
 		for (auto &jobTuple : sliceJobs_) {
-			lowerBound = std::min(lowerBound, jobTuple.second.lastCallEnd);
+			lowerBound = std::min(lowerBound, jobTuple.second.nextCallStart);
 		}
 
 		// discard fully processed events and readjust call boundaries of jobs
 		storePacket_ = storePacket_.slice(lowerBound);
 		for (auto &jobTuple : sliceJobs_) {
-			jobTuple.second.lastCallEnd = jobTuple.second.lastCallEnd - lowerBound;
+			jobTuple.second.nextCallStart = jobTuple.second.nextCallStart - lowerBound;
 		}
 	}
 
-public:
 	EventStreamSlicer() = default;
 
+	/**
+	 * Creates a new slicer with the given execution policy for its jobs.
+	 * @param executionPolicy How the jobs should be executed on new data
+	 */
+	explicit EventStreamSlicer(ExecutionPolicy executionPolicy) : executionPolicy_(executionPolicy) {
+	}
+
+	/**
+	 * Sets how the jobs get executed on new data. With `PARALLEL`, jobs run
+	 * concurrently, but processed data is only discarded once all of them
+	 * have completed.
+	 * @param executionPolicy The new execution policy
+	 */
+	void setExecutionPolicy(ExecutionPolicy executionPolicy) {
+		executionPolicy_ = executionPolicy;
+	}
+
+	/**
+	 * @return The current execution policy of the jobs
+	 */
+	ExecutionPolicy getExecutionPolicy() const {
+		return executionPolicy_;
+	}
+
 	/**
 	 * Adds a single event to the slicer buffer and evaluate jobs.
 	 * @param evt the event to be added to the buffer
@@ -1120,8 +1621,27 @@ public:
 	 * @return A handle to uniquely identify the job.
 	 */
 	slicejob_t doEveryNumberOfEvents(size_t n, std::function<void(const EventStore &)> callback) {
+		return doEveryNumberOfEvents(n, 0, std::move(callback));
+	}
+
+	/**
+	 * Adds a sliding-window, number-of-events triggered job to the Slicer.
+	 * The slicer calls the callback function every `n` events, with the last
+	 * `window` events. If `window` is bigger than `n`, consecutive calls share
+	 * data. The shared data is not copied, all windows reference the same
+	 * underlying shards.
+	 * @param n the interval (in number of events) in which the callback
+	 * should be called
+	 * @param window the number of events passed to the callback on every call.
+	 * 0 to use back-to-back windows of `n` events.
+	 * @param callback the callback function that gets called on the data
+	 * every interval
+	 * @return A handle to uniquely identify the job.
+	 */
+	slicejob_t doEveryNumberOfEvents(size_t n, size_t window, std::function<void(const EventStore &)> callback) {
 		hashCounter_ += 1;
-		sliceJobs_.emplace(std::make_pair(hashCounter_, SliceJob(SliceJob::SliceType::NUMBER, 0, n, callback)));
+		sliceJobs_.emplace(
+			std::make_pair(hashCounter_, SliceJob(SliceJob::SliceType::NUMBER, 0, n, 0, window, std::move(callback))));
 		return hashCounter_;
 	}
 
@@ -1143,8 +1663,49 @@ public:
 	 * @return A handle to uniquely identify the job.
 	 */
 	slicejob_t doEveryTimeInterval(time_t time, std::function<void(const EventStore &)> callback) {
+		return doEveryTimeInterval(time, 0, std::move(callback));
+	}
+
+	/**
+	 * Adds a sliding-window, event-timestamp-interval triggered job to the
+	 * Slicer. The slicer calls the callback every `time` (in event-time), with
+	 * the events of a window of length `window` starting at that time. If
+	 * `window` is bigger than `time`, consecutive calls share data. The shared
+	 * data is not copied, all windows reference the same underlying shards.
+	 * @param time the interval (in event-time) in which the callback
+	 * should be called
+	 * @param window the length (in event-time) of the data passed to the
+	 * callback on every call. 0 to use back-to-back windows of length `time`.
+	 * @param callback the callback function that gets called on the data
+	 * every interval
+	 * @return A handle to uniquely identify the job.
+	 */
+	slicejob_t doEveryTimeInterval(time_t time, time_t window, std::function<void(const EventStore &)> callback) {
+		hashCounter_ += 1;
+		sliceJobs_.emplace(
+			std::make_pair(hashCounter_, SliceJob(SliceJob::SliceType::TIME, time, 0, window, 0, std::move(callback))));
+		return hashCounter_;
+	}
+
+	/**
+	 * Adds a wall-clock triggered job to the Slicer. The slicer calls the
+	 * callback every `interval` of (monotonic) CPU time, with all events
+	 * received since the last call. The callback is also called when no
+	 * events were received, with an empty store. As the slicer has no thread
+	 * of its own, the calls happen during `evaluate()`, which is invoked on
+	 * new data or manually. If it is invoked late, the call is late, too;
+	 * missed calls are not repeated.
+	 * @param interval the interval (in wall-clock µs) in which the callback
+	 * should be called
+	 * @param callback the callback function that gets called on the data
+	 * every interval
+	 * @return A handle to uniquely identify the job.
+	 */
+	slicejob_t doEveryClockInterval(time_t interval, std::function<void(const EventStore &)> callback) {
 		hashCounter_ += 1;
-		sliceJobs_.emplace(std::make_pair(hashCounter_, SliceJob(SliceJob::SliceType::TIME, time, 0, callback)));
+		SliceJob job(SliceJob::SliceType::CLOCK, 0, 0, 0, 0, std::move(callback));
+		job.setClockInterval(interval);
+		sliceJobs_.emplace(std::make_pair(hashCounter_, std::move(job)));
 		return hashCounter_;
 	}
 
@@ -1191,6 +1752,60 @@ public:
 		}
 		sliceJobs_[job].setNumberInterval(numberInterval);
 	}
+
+	/**
+	 * Modifies the time window of the supplied job to the requested value
+	 * @param job the job whose time window should be changed
+	 * @param timeWindow the new time window value, 0 for back-to-back windows
+	 */
+	void modifyTimeWindow(slicejob_t job, time_t timeWindow) {
+		if (!hasJob(job)) {
+			return;
+		}
+		sliceJobs_[job].setTimeWindow(timeWindow);
+	}
+
+	/**
+	 * Modifies the number window of the supplied job to the requested value
+	 * @param job the job whose number window should be changed
+	 * @param numberWindow the new number window value, 0 for back-to-back windows
+	 */
+	void modifyNumberWindow(slicejob_t job, size_t numberWindow) {
+		if (!hasJob(job)) {
+			return;
+		}
+		sliceJobs_[job].setNumberWindow(numberWindow);
+	}
+
+	/**
+	 * Modifies the wall-clock interval of the supplied clock job to the
+	 * requested value
+	 * @param job the clock job whose interval should be changed
+	 * @param clockInterval the new interval value, in wall-clock µs
+	 */
+	void modifyClockInterval(slicejob_t job, time_t clockInterval) {
+		if (!hasJob(job)) {
+			return;
+		}
+		sliceJobs_[job].setClockInterval(clockInterval);
+	}
+
+	/**
+	 * Sets a wall-clock timeout on the supplied number or time job. If the
+	 * callback of the job was not called for `clockTimeout` of CPU time, the
+	 * job gets flushed: the callback is called with the incomplete window,
+	 * or an empty store if there are no new events, and the windows restart
+	 * after the flushed data. This way a job keeps producing output, even if
+	 * the event stream is quiet. Timeouts are checked during `evaluate()`.
+	 * @param job the job whose timeout should be changed
+	 * @param clockTimeout the new timeout, in wall-clock µs, 0 to disable
+	 */
+	void modifyClockTimeout(slicejob_t job, time_t clockTimeout) {
+		if (!hasJob(job)) {
+			return;
+		}
+		sliceJobs_[job].setClockTimeout(clockTimeout);
+	}
 };
 
 /**
@@ -1272,6 +1887,36 @@ public:
 		return data_.get()[(unsigned long) (y * cols + x)];
 	}
 
+	/**
+	 * Returns a pointer to the first element of the given row. The rows
+	 * are stored contiguously, so the pointer can be used to iterate over
+	 * the row, or over the whole matrix when starting at row 0.
+	 * @param y The row to get the pointer to
+	 * @return A pointer to the first element of row `y`
+	 */
+	inline time_t *ptr(coord_t y = 0) const {
+		return data_.get() + (unsigned long) (y * cols);
+	}
+
+	/**
+	 * Copies the times of the given row into `out`. Shares the interface
+	 * with `TimeMat32`, which has to decode them.
+	 * @param y The row to copy
+	 * @param out Destination, must hold `cols` elements
+	 */
+	inline void decodeRow(coord_t y, time_t *out) const {
+		std::copy_n(ptr(y), cols, out);
+	}
+
+	/**
+	 * Sets all elements of the given row to the given time.
+	 * @param y The row to set
+	 * @param time The time to set the elements to
+	 */
+	inline void fillRow(coord_t y, time_t time) {
+		std::fill_n(ptr(y), cols, time);
+	}
+
 	/**
 	 * Creates a new OpenCV matrix of the type given and copies the time
 	 * data into this OpenCV matrix. The data in the TimeMat is of unsigned
@@ -1345,6 +1990,310 @@ public:
 		addImpl((const time_t) -s, *this);
 		return *this;
 	}
+
+	/**
+	 * Does nothing, as a TimeMat can hold any time. Exists to share the
+	 * interface with `TimeMat32`.
+	 * @param time The highest time to be stored next
+	 */
+	inline void ensureRepresentable(time_t time) const {
+		(void) time;
+	}
+};
+
+/**
+ * Compact alternative to `TimeMat`, using 4 instead of 8 bytes per element.
+ * Times are stored as 32 bit offsets relative to a common epoch, which
+ * gives a window of about 71 minutes of representable times. When a time
+ * beyond the window is stored, the epoch is moved forward automatically
+ * (rebasing), keeping the most recent half of the window. Times that
+ * drop out of the window in the process are set to 0, the same value
+ * a freshly created matrix holds.
+ *
+ * The interface is the same as the one of `TimeMat`. As the elements
+ * are not stored as `time_t`, `at` returns a proxy that converts to
+ * and can be assigned from `time_t`.
+ *
+ * Like with `TimeMat`, copies share the data.
+ */
+class TimeMat32 {
+private:
+	struct Storage {
+		std::unique_ptr<uint32_t[]> data;
+		time_t epoch = 0;
+	};
+
+	std::shared_ptr<Storage> storage_;
+
+	/** 0 is reserved for time 0, all other offsets are shifted by one */
+	static constexpr time_t MAX_OFFSET = std::numeric_limits<uint32_t>::max();
+	/** how much of the window is kept on rebasing */
+	static constexpr time_t REBASE_KEEP = MAX_OFFSET / 2;
+
+	inline size_t length() const {
+		return (size_t) rows * (size_t) cols;
+	}
+
+	inline time_t decode(uint32_t value) const {
+		return (value == 0) ? 0 : storage_->epoch + (time_t) value - 1;
+	}
+
+	/**
+	 * Moves the epoch to the given time, times before it are set to 0.
+	 */
+	void rebase(time_t newEpoch) {
+		const time_t shift = newEpoch - storage_->epoch;
+		uint32_t *data     = storage_->data.get();
+		const auto len     = length();
+
+		for (size_t i = 0; i < len; i++) {
+			data[i] = ((time_t) data[i] > shift) ? (uint32_t) ((time_t) data[i] - shift) : 0;
+		}
+		storage_->epoch = newEpoch;
+	}
+
+	inline void store(size_t index, time_t time) {
+		if (time - storage_->epoch + 1 > MAX_OFFSET) {
+			rebase(time - REBASE_KEEP);
+		}
+
+		const time_t offset        = time - storage_->epoch + 1;
+		storage_->data.get()[index] = (time <= 0 || offset <= 0) ? 0 : (uint32_t) offset;
+	}
+
+	void addImpl(time_t a, TimeMat32 &target) const {
+		if (target.storage_ != storage_) {
+			std::copy_n(storage_->data.get(), length(), target.storage_->data.get());
+		}
+		target.storage_->epoch = storage_->epoch + a;
+
+		// times that would become negative are bounds checked to 0
+		if (target.storage_->epoch < 0) {
+			target.rebase(0);
+		}
+	}
+
+public:
+	/**
+	 * Reference to an element of a TimeMat32. Converts to and can be
+	 * assigned from `time_t`.
+	 */
+	class Reference {
+	private:
+		TimeMat32 &mat_;
+		size_t index_;
+
+	public:
+		Reference(TimeMat32 &mat, size_t index) : mat_(mat), index_(index) {
+		}
+
+		inline operator time_t() const {
+			return mat_.decode(mat_.storage_->data.get()[index_]);
+		}
+
+		inline Reference &operator=(time_t time) {
+			mat_.store(index_, time);
+			return *this;
+		}
+
+		inline Reference &operator=(const Reference &other) {
+			return *this = static_cast<time_t>(other);
+		}
+	};
+
+	/**
+	 * Dummy constructor
+	 * Constructs a new, empty TimeMat32 without any data allocated to it.
+	 */
+	TimeMat32() = default;
+
+	/**
+	 * Creates a new TimeMat32 of the given size. The Mat is zero initialized.
+	 * @param size
+	 */
+	explicit TimeMat32(const cv::Size size) :
+		storage_(std::make_shared<Storage>()),
+		rows(static_cast<coord_t>(size.height)),
+		cols(static_cast<coord_t>(size.width)) {
+		storage_->data = std::unique_ptr<uint32_t[]>(new uint32_t[length()]{0});
+	}
+
+	/**
+	 * Copy constructor, constructs a new TimeMat32 with shared ownership of the data.
+	 * @param other The TimeMat32 to be copied. The data is not copied but takes shared ownership.
+	 */
+	TimeMat32(const TimeMat32 &other) = default;
+
+	/**
+	 * The height of the TimeMat32.
+	 */
+	coord_t rows = 0;
+
+	/**
+	 * The width of the TimeMat32.
+	 */
+	coord_t cols = 0;
+
+	/**
+	 * The size of the TimeMat32.
+	 * @return
+	 */
+	inline cv::Size size() const {
+		return cv::Size(cols, rows);
+	}
+
+	/**
+	 * Returns true if the TimeMat32 has zero size. In this case, it was not
+	 * allocated with a size.
+	 * @return true if the TimeMat32 does not have a size > 0
+	 */
+	inline bool empty() {
+		return rows == 0 || cols == 0;
+	}
+
+	/**
+	 * Returns a reference to the element at the given coordinates.
+	 * The element can both be read from as well as written to.
+	 * Writing may rebase the whole matrix, see `ensureRepresentable`.
+	 * @param y The y coordinate of the element to be accessed.
+	 * @param x The x coordinate of the element to be accessed.
+	 * @return A reference to the element at the requested coordinats.
+	 */
+	inline Reference at(coord_t y, coord_t x) const {
+		return Reference(const_cast<TimeMat32 &>(*this), (size_t) (y * cols + x));
+	}
+
+	/**
+	 * @return The time all stored times are relative to
+	 */
+	inline time_t getEpoch() const {
+		return storage_->epoch;
+	}
+
+	/**
+	 * Returns a pointer to the raw offsets of the given row, stored
+	 * contiguously. An offset of 0 means time 0, any other offset `v`
+	 * the time `getEpoch() + v - 1`.
+	 * @param y The row to get the pointer to
+	 * @return A pointer to the first offset of row `y`
+	 */
+	inline const uint32_t *ptr(coord_t y = 0) const {
+		return storage_->data.get() + (size_t) (y * cols);
+	}
+
+	/**
+	 * Decodes the times of the given row into `out`, without branches so
+	 * that the loop can be vectorized.
+	 * @param y The row to decode
+	 * @param out Destination, must hold `cols` elements
+	 */
+	inline void decodeRow(coord_t y, time_t *out) const {
+		const uint32_t *row = ptr(y);
+		const time_t base   = storage_->epoch - 1;
+
+		for (coord_t x = 0; x < cols; x++) {
+			out[x] = (row[x] == 0) ? 0 : base + (time_t) row[x];
+		}
+	}
+
+	/**
+	 * Sets all elements of the given row to the given time. Encodes the
+	 * time once, rebasing first if needed.
+	 * @param y The row to set
+	 * @param time The time to set the elements to
+	 */
+	inline void fillRow(coord_t y, time_t time) {
+		ensureRepresentable(time);
+
+		const time_t offset = time - storage_->epoch + 1;
+		std::fill_n(storage_->data.get() + (size_t) (y * cols), cols,
+			(time <= 0 || offset <= 0) ? (uint32_t) 0 : (uint32_t) offset);
+	}
+
+	/**
+	 * Rebases the matrix if needed, so that times up to the given one can
+	 * be stored without rebasing. Call this before writing to the matrix
+	 * from multiple threads, as a rebase touches every element.
+	 * @param time The highest time to be stored next
+	 */
+	void ensureRepresentable(time_t time) {
+		if (time - storage_->epoch + 1 > MAX_OFFSET) {
+			rebase(time - REBASE_KEEP);
+		}
+	}
+
+	/**
+	 * Creates a new OpenCV matrix of the type given and copies the time
+	 * data into this OpenCV matrix. Make sure that the range of the values
+	 * in the TimeMat32 can be mapped onto the OpenCV type requested.
+	 * @tparam T The type of the OpenCV Mat to be generated.
+	 * @return An OpenCV Mat of the requested type.
+	 */
+	template<class T> cv::Mat getOCVMat() const {
+		cv::Mat mat(rows, cols, cv::DataType<T>::type);
+
+		for (coord_t y = 0; y < rows; y++) {
+			for (coord_t x = 0; x < cols; x++) {
+				mat.at<T>(y, x) = (T) decode(storage_->data.get()[(size_t) (y * cols + x)]);
+			}
+		}
+		return mat;
+	}
+
+	/**
+	 * Adds a constant to the TimeMat32. Only moves the epoch, unless times
+	 * become negative. Values are bounds checked to 0. If the new time would
+	 * become negative, it is set to 0. Unlike with `TimeMat`, elements holding
+	 * 0 (no time) stay at 0.
+	 * @tparam T The type of the constant. Accepts any numeric type.
+	 * @param s The constant to be added
+	 * @return A new TimeMat32 with the changed times
+	 */
+	template<typename T> inline TimeMat32 operator+(const T &s) const {
+		TimeMat32 tm(cv::Size(cols, rows));
+		addImpl((const time_t) s, tm);
+		return tm;
+	}
+
+	/**
+	 * Adds a constant to the TimeMat32.
+	 * Values are bounds checked to 0. If the new time would become negative,
+	 * it is set to 0. Unlike with `TimeMat`, elements holding 0 stay at 0.
+	 * @tparam T The type of the constant. Accepts any numeric type.
+	 * @param s The constant to be added
+	 * @return A reference to the TimeMat32
+	 */
+	template<typename T> inline TimeMat32 &operator+=(const T &s) {
+		addImpl((const time_t) s, *this);
+		return *this;
+	}
+
+	/**
+	 * Subtracts a constant to the TimeMat32.
+	 * Values are bounds checked to 0. If the new time would become negative,
+	 * it is set to 0. Unlike with `TimeMat`, elements holding 0 stay at 0.
+	 * @tparam T The type of the constant. Accepts any numeric type.
+	 * @param s The constant to be subtracted
+	 * @return A new TimeMat32 with the changed times
+	 */
+	template<typename T> inline TimeMat32 operator-(const T &s) const {
+		TimeMat32 tm(cv::Size(cols, rows));
+		addImpl((const time_t) -s, tm);
+		return tm;
+	}
+
+	/**
+	 * Subtracts a constant to the TimeMat32.
+	 * Values are bounds checked to 0. If the new time would become negative,
+	 * it is set to 0. Unlike with `TimeMat`, elements holding 0 stay at 0.
+	 * @tparam T The type of the constant. Accepts any numeric type.
+	 * @param s The constant to be subtracted
+	 * @return A reference to the TimeMat32
+	 */
+	template<typename T> inline TimeMat32 &operator-=(const T &s) {
+		addImpl((const time_t) -s, *this);
+		return *this;
+	}
 };
 
 } // namespace dv
@@ -105,11 +105,12 @@ inline void rateLimitFilter(const EventStore &in, EventStore &out, double rate)
  * Stateful per-pixel rate limiting filter. Reduces the number of events per pixel
  * to a defined value per second. The first event at every location is kept, subsequent events
  * are only kept if they arise after 1/rate seconds after the last kept event.
+ * @tparam TimeMatType The matrix type the last emission times are stored in
  */
-class RateLimitFilter {
+template<class TimeMatType> class RateLimitFilterBase {
 private:
 	double rate_;
-	TimeMat lastEmitSurface_;
+	TimeMatType lastEmitSurface_;
 
 public:
 	/**
@@ -121,9 +122,9 @@ public:
 	 * x coordinate of the expected data
 	 * @param rate The rate of events (in events/second) that should pass the filter
 	 */
-	RateLimitFilter(coord_t rows, coord_t cols, double rate) :
+	RateLimitFilterBase(coord_t rows, coord_t cols, double rate) :
 		rate_(rate),
-		lastEmitSurface_(TimeMat(cv::Size(cols, rows))) {
+		lastEmitSurface_(TimeMatType(cv::Size(cols, rows))) {
 	}
 
 	/**
@@ -132,7 +133,7 @@ public:
 	 * @param size The height and width of the expected event data.
 	 * @param rate The rate of events (in events/second) that should pass the filter
 	 */
-	RateLimitFilter(const cv::Size &size, double rate) : RateLimitFilter(size.height, size.height, rate) {
+	RateLimitFilterBase(const cv::Size &size, double rate) : RateLimitFilterBase(size.height, size.width, rate) {
 	}
 
 	/**
@@ -153,6 +154,187 @@ public:
 	}
 };
 
+/**
+ * RateLimitFilter storing the last emission times in a `TimeMat`.
+ */
+using RateLimitFilter = RateLimitFilterBase<TimeMat>;
+
+/**
+ * RateLimitFilter storing the last emission times in the more compact `TimeMat32`.
+ */
+using RateLimitFilter32 = RateLimitFilterBase<TimeMat32>;
+
+/**
+ * Stateful spatio-temporal correlation filter, removes uncorrelated
+ * background activity noise. An event is kept if enough of the cells around
+ * its own cell saw an event within the correlation time. The sensor is
+ * divided into square cells of 2^subsample pixels per side, and only the
+ * time of the last event of every cell is stored. Memory is O(pixels /
+ * 4^subsample), the work per event is constant: nine reads and one write.
+ * Every event updates its cell, whether it is kept or not.
+ * @tparam TimeMatType The matrix type the last event times are stored in
+ */
+template<class TimeMatType> class CorrelationFilterBase {
+private:
+	cv::Size size_;
+	time_t correlationTime_ = 0;
+	int supportMin_         = 1;
+	int subsample_          = 0;
+	bool splitPolarity_     = false;
+	/** last event time per cell, with a border of one never written cell */
+	TimeMatType positiveCells_;
+	/** last event time per cell of negative events, with separate polarities */
+	TimeMatType negativeCells_;
+
+	void allocateCells() {
+		const cv::Size cellsSize(((size_.width + (1 << subsample_) - 1) >> subsample_) + 2,
+			((size_.height + (1 << subsample_) - 1) >> subsample_) + 2);
+
+		positiveCells_ = TimeMatType(cellsSize);
+		negativeCells_ = (splitPolarity_) ? TimeMatType(cellsSize) : positiveCells_;
+	}
+
+public:
+	/**
+	 * Silly default constructor. This generates a filter with zero size,
+	 * that only exists to be redefined later.
+	 */
+	CorrelationFilterBase() = default;
+
+	/**
+	 * Creates a new, stateful correlation filter.
+	 * @param size The size of the expected event data
+	 * @param correlationTime The maximum time since the last event of a
+	 * neighboring cell for it to support an event
+	 * @param supportMin The minimum number of supporting neighboring cells,
+	 * out of eight, for an event to be kept
+	 * @param subsample The cell side length is 2^subsample pixels
+	 * @param splitPolarity If true, only events of the same polarity support
+	 * each other
+	 */
+	CorrelationFilterBase(const cv::Size &size, time_t correlationTime, int supportMin = 1, int subsample = 0,
+		bool splitPolarity = false) :
+		size_(size),
+		correlationTime_(correlationTime),
+		supportMin_(supportMin),
+		subsample_(subsample),
+		splitPolarity_(splitPolarity) {
+		allocateCells();
+	}
+
+	/**
+	 * Checks a single event against the state of the filter and updates the
+	 * state with it. Events have to be passed in order of time.
+	 * @param event The event to check
+	 * @return true if the event is correlated and should be kept
+	 */
+	inline bool accept(const Event &event) {
+		const time_t time = event.timestamp();
+		const auto cellX  = static_cast<coord_t>((event.x() >> subsample_) + 1);
+		const auto cellY  = static_cast<coord_t>((event.y() >> subsample_) + 1);
+		TimeMatType &cells = (event.polarity()) ? positiveCells_ : negativeCells_;
+
+		// Branch-free count over the 3x3 neighborhood, rows are contiguous.
+		int support = 0;
+		for (coord_t y = cellY - 1; y <= cellY + 1; y++) {
+			for (coord_t x = cellX - 1; x <= cellX + 1; x++) {
+				support += static_cast<int>((time - static_cast<time_t>(cells.at(y, x))) <= correlationTime_);
+			}
+		}
+
+		// The own cell does not support its events.
+		support -= static_cast<int>((time - static_cast<time_t>(cells.at(cellY, cellX))) <= correlationTime_);
+
+		cells.at(cellY, cellX) = time;
+
+		return (support >= supportMin_);
+	}
+
+	/**
+	 * Filters the incoming events, updating the state of the filter.
+	 * @param in the incoming events, won't get modified
+	 * @param out the outgoing EventStore to where the kept events get added.
+	 */
+	void filter(const EventStore &in, EventStore &out) {
+		// in-place filtering is not supported
+		assert(&in != &out);
+
+		for (const Event &event : in) {
+			if (accept(event)) {
+				out.addEvent(event);
+			}
+		}
+	}
+
+	/**
+	 * Sets the maximum time since the last event of a neighboring cell for
+	 * it to support an event.
+	 * @param correlationTime The correlation time
+	 */
+	void setCorrelationTime(time_t correlationTime) {
+		correlationTime_ = correlationTime;
+	}
+
+	/**
+	 * Sets the minimum number of supporting neighboring cells, out of eight,
+	 * for an event to be kept.
+	 * @param supportMin The minimum number of supporting cells
+	 */
+	void setSupportMin(int supportMin) {
+		supportMin_ = supportMin;
+	}
+
+	/**
+	 * Sets the cell side length to 2^subsample pixels. Changing it resets
+	 * the state of the filter.
+	 * @param subsample The cell size exponent
+	 */
+	void setSubsample(int subsample) {
+		if (subsample != subsample_) {
+			subsample_ = subsample;
+			allocateCells();
+		}
+	}
+
+	/**
+	 * Sets whether only events of the same polarity support each other.
+	 * Changing it resets the state of the filter.
+	 * @param splitPolarity true to separate the polarities
+	 */
+	void setSplitPolarity(bool splitPolarity) {
+		if (splitPolarity != splitPolarity_) {
+			splitPolarity_ = splitPolarity;
+			allocateCells();
+		}
+	}
+
+	time_t getCorrelationTime() const {
+		return correlationTime_;
+	}
+
+	int getSupportMin() const {
+		return supportMin_;
+	}
+
+	int getSubsample() const {
+		return subsample_;
+	}
+
+	bool isSplitPolarity() const {
+		return splitPolarity_;
+	}
+};
+
+/**
+ * CorrelationFilter storing the last event times in a `TimeMat`.
+ */
+using CorrelationFilter = CorrelationFilterBase<TimeMat>;
+
+/**
+ * CorrelationFilter storing the last event times in the more compact `TimeMat32`.
+ */
+using CorrelationFilter32 = CorrelationFilterBase<TimeMat32>;
+
 /**
  * Computes and returns a rectangle with dimensions such that all the events
  * in the given `EventStore` fall into the bounding box.
@@ -169,12 +351,14 @@ inline cv::Rect boundingRect(const EventStore &packet) {
 	coord_t minY = std::numeric_limits<coord_t>::max();
 	coord_t maxY = 0;
 
-	for (const Event &event : packet) {
-		minX = std::min(event.x(), minX);
-		maxX = std::max(event.x(), maxX);
-		minY = std::min(event.y(), minY);
-		maxY = std::max(event.y(), maxY);
-	}
+	packet.forEachChunk([&minX, &maxX, &minY, &maxY](const Event *begin, const Event *end) {
+		for (const Event *event = begin; event < end; event++) {
+			minX = std::min(event->x(), minX);
+			maxX = std::max(event->x(), maxX);
+			minY = std::min(event->y(), minY);
+			maxY = std::max(event->y(), maxY);
+		}
+	});
 
 	return cv::Rect(minX, minY, maxX - minX, maxY - minY);
 }
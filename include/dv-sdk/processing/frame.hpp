@@ -23,8 +23,12 @@ template<typename T> int sgn(T val) {
  * Accumulation of the events is performed on a floating point frame,
  * with every event contributing a fixed amount to the potential. Timestamps
  * of the last contributions are stored as well, to allow for a decay.
+ *
+ * Use `Accumulator` to store the timestamps in a `TimeMat`, or `Accumulator32`
+ * to store them in the more compact `TimeMat32`.
+ * @tparam TimeMatType The matrix type the timestamps are stored in
  */
-class Accumulator {
+template<class TimeMatType> class AccumulatorBase {
 public:
 	/**
 	 * Decay function to be used to decay the surface potential.
@@ -60,11 +64,56 @@ private:
 	cv::Size shape_;
 
 	// state
-	TimeMat decayTimeSurface_;
+	TimeMatType decayTimeSurface_;
 	cv::Mat potentialSurface_;
 	time_t highestTime_;
 
+	// exponential decay lookup, exp(-dt / tau) = low[dt % size] * high[dt / size]
+	static constexpr int EXP_LUT_BITS   = 12;
+	static constexpr time_t EXP_LUT_SIZE = 1 << EXP_LUT_BITS;
+	std::vector<float> expDecayLow_;
+	std::vector<float> expDecayHigh_;
+
+	// scratch buffers for the synchronous decay
+	cv::Mat decayBuffer_;
+	std::vector<time_t> decayTimes_;
+
+	// parallel accumulation
+	int numThreads_ = 1;
+	RowTileScheduler tileScheduler_;
+
 	// internal use methods
+	/**
+	 * __INTERNAL_USE_ONLY__
+	 * Recomputes the exponential decay lookup tables for the current decay param.
+	 * The tables cover time differences up to `EXP_LUT_SIZE^2` µs (about 16.7s)
+	 * exactly, the product of both entries differs from `std::exp` only by float
+	 * rounding (relative error below 1e-6).
+	 */
+	void updateDecayLUT() {
+		expDecayLow_.resize(EXP_LUT_SIZE);
+		expDecayHigh_.resize(EXP_LUT_SIZE);
+
+		for (time_t i = 0; i < EXP_LUT_SIZE; i++) {
+			expDecayLow_[(size_t) i]  = (float) std::exp(-((double) i) / decayParam_);
+			expDecayHigh_[(size_t) i] = (float) std::exp(-((double) (i * EXP_LUT_SIZE)) / decayParam_);
+		}
+	}
+
+	/**
+	 * __INTERNAL_USE_ONLY__
+	 * @param deltaTime The time passed since the last decay, must not be negative
+	 * @return The exponential decay factor `e^(-deltaTime / tau)`
+	 */
+	inline float exponentialDecayFactor(time_t deltaTime) const {
+		const time_t high = deltaTime >> EXP_LUT_BITS;
+		if (high >= EXP_LUT_SIZE) {
+			return (float) std::exp(-((double) deltaTime) / decayParam_);
+		}
+
+		return expDecayLow_[(size_t) (deltaTime & (EXP_LUT_SIZE - 1))] * expDecayHigh_[(size_t) high];
+	}
+
 	/**
 	 * __INTERNAL_USE_ONLY__
 	 * Decays the potential at coordinates x, y to the given time, respecting the
@@ -96,9 +145,8 @@ private:
 			}
 
 			case EXPONENTIAL: {
-				potentialSurface_.at<float>(y, x)
-					= lastPotential * (float) std::exp(-((double) (time - lastDecayTime)) / decayParam_);
-				decayTimeSurface_.at(y, x) = time;
+				potentialSurface_.at<float>(y, x) = lastPotential * exponentialDecayFactor(time - lastDecayTime);
+				decayTimeSurface_.at(y, x)        = time;
 				break;
 			}
 
@@ -115,6 +163,76 @@ private:
 		}
 	}
 
+	/**
+	 * __INTERNAL_USE_ONLY__
+	 * Decays the whole potential surface to the given time. Equivalent to calling
+	 * `decay()` on every pixel, but works row by row on contiguous memory so the
+	 * loops can be vectorized: the times of each row are decoded once into a
+	 * buffer, and set again with a single fill. The exponential function is
+	 * evaluated with OpenCV's vectorized `cv::exp` on the whole frame.
+	 * @param time The time to which the surface should be decayed to.
+	 */
+	void decayAll(time_t time) {
+		if (decayFunction_ == NONE || potentialSurface_.empty()) {
+			return;
+		}
+
+		decayTimeSurface_.ensureRepresentable(time);
+
+		decayTimes_.resize((size_t) shape_.width);
+		time_t *lastTimes = decayTimes_.data();
+
+		switch (decayFunction_) {
+			case LINEAR: {
+				const auto slope   = (float) decayParam_;
+				const auto neutral = neutralPotential_;
+				for (coord_t r = 0; r < shape_.height; r++) {
+					decayTimeSurface_.decodeRow(r, lastTimes);
+					float *potential = potentialSurface_.ptr<float>(r);
+					for (coord_t c = 0; c < shape_.width; c++) {
+						const float decayed = (float) (time - lastTimes[c]) * slope;
+						potential[c] = (potential[c] >= neutral) ? std::max(potential[c] - decayed, neutral)
+																 : std::min(potential[c] + decayed, neutral);
+					}
+					decayTimeSurface_.fillRow(r, time);
+				}
+				break;
+			}
+
+			case EXPONENTIAL: {
+				decayBuffer_.create(shape_, CV_32F);
+				const auto scale = (float) (-1.0 / decayParam_);
+				for (coord_t r = 0; r < shape_.height; r++) {
+					decayTimeSurface_.decodeRow(r, lastTimes);
+					float *exponent = decayBuffer_.ptr<float>(r);
+					for (coord_t c = 0; c < shape_.width; c++) {
+						exponent[c] = (float) (time - lastTimes[c]) * scale;
+					}
+					decayTimeSurface_.fillRow(r, time);
+				}
+				cv::exp(decayBuffer_, decayBuffer_);
+				cv::multiply(potentialSurface_, decayBuffer_, potentialSurface_);
+				break;
+			}
+
+			case STEP: {
+				const auto neutral = neutralPotential_;
+				for (coord_t r = 0; r < shape_.height; r++) {
+					decayTimeSurface_.decodeRow(r, lastTimes);
+					float *potential = potentialSurface_.ptr<float>(r);
+					for (coord_t c = 0; c < shape_.width; c++) {
+						potential[c] = ((double) (time - lastTimes[c]) > decayParam_) ? neutral : potential[c];
+					}
+				}
+				break;
+			}
+
+			default: {
+				break;
+			}
+		}
+	}
+
 	/**
 	 * __INTERNAL_USE_ONLY__
 	 * Contributes the effect of a single event onto the potential surface.
@@ -144,7 +262,7 @@ public:
 	 * An accumulator with zero size does not work. This constructor just exists
 	 * to make it possible to default initialize an Accumulator to later redefine.
 	 */
-	Accumulator() = default;
+	AccumulatorBase() = default;
 
 	/**
 	 * Accumulator constructor
@@ -179,7 +297,7 @@ public:
 	 * @param rectifyPolarity Describes if the polarity of the events should be kept
 	 * or ignored. If set to true, all events behave like positive events.
 	 */
-	Accumulator(const cv::Size &size, Accumulator::Decay decayFunction, double decayParam, bool synchronousDecay,
+	AccumulatorBase(const cv::Size &size, Decay decayFunction, double decayParam, bool synchronousDecay,
 		float eventContribution, float maxPotential, float neutralPotential, float minPotential, bool rectifyPolarity) :
 		rectifyPolarity_(rectifyPolarity),
 		eventContribution_(eventContribution),
@@ -190,9 +308,10 @@ public:
 		decayParam_(decayParam),
 		synchronousDecay_(synchronousDecay),
 		shape_(size),
-		decayTimeSurface_(TimeMat(size)),
+		decayTimeSurface_(TimeMatType(size)),
 		potentialSurface_(cv::Mat(size, CV_32F, neutralPotential)),
 		highestTime_(0) {
+		updateDecayLUT();
 	}
 
 	/**
@@ -210,9 +329,19 @@ public:
 			return;
 		}
 
-		for (const Event &event : packet) {
-			decay(event.x(), event.y(), event.timestamp());
-			contribute(event.x(), event.y(), event.polarity(), event.timestamp());
+		if (numThreads_ == 1) {
+			for (const Event &event : packet) {
+				decay(event.x(), event.y(), event.timestamp());
+				contribute(event.x(), event.y(), event.polarity(), event.timestamp());
+			}
+		}
+		else {
+			// writing times must not rebase the time surface while the tiles are processed
+			decayTimeSurface_.ensureRepresentable(packet.getHighestTime());
+			tileScheduler_.forEachEvent(packet, shape_.height, numThreads_, [this](const Event &event) {
+				decay(event.x(), event.y(), event.timestamp());
+				contribute(event.x(), event.y(), event.polarity(), event.timestamp());
+			});
 		}
 		highestTime_ = packet.getHighestTime();
 	}
@@ -228,11 +357,7 @@ public:
 	cv::Mat generateFrame(time_t time) {
 		if (synchronousDecay_) {
 			assert(time >= highestTime_);
-			for (int r = 0; r < potentialSurface_.rows; r++) {
-				for (int c = 0; c < potentialSurface_.cols; c++) {
-					decay(c, r, time);
-				}
-			}
+			decayAll(time);
 		}
 		cv::Mat out;
 		potentialSurface_.copyTo(out);
@@ -251,6 +376,37 @@ public:
 		return generateFrame(highestTime_);
 	}
 
+	/**
+	 * Generates the accumulation frame (potential surface) at the provided time
+	 * and renders it into the given 8 bit matrix, mapping the potential range
+	 * `minPotential` to `maxPotential` onto 0 to 255. Scaling, shifting and
+	 * clamping happen in a single vectorized pass, without intermediate copies.
+	 * `out` is only reallocated if it does not have the frame size and type
+	 * CV_8U, so it can wrap existing memory, like the pixels of an output frame.
+	 * @param time The time at which the frame should get generated
+	 * @param out The matrix to render the frame into
+	 */
+	void generateFrame(time_t time, cv::Mat &out) {
+		if (synchronousDecay_) {
+			assert(time >= highestTime_);
+			decayAll(time);
+		}
+
+		const double scale = 255.0 / static_cast<double>(maxPotential_ - minPotential_);
+		const double shift = -static_cast<double>(minPotential_) * scale;
+		potentialSurface_.convertTo(out, CV_8U, scale, shift);
+	}
+
+	/**
+	 * Generates the accumulation frame (potential surface) at the time of the
+	 * last consumed event and renders it into the given 8 bit matrix.
+	 * See `generateFrame(time_t, cv::Mat &)`.
+	 * @param out The matrix to render the frame into
+	 */
+	void generateFrame(cv::Mat &out) {
+		generateFrame(highestTime_, out);
+	}
+
 	/**
 	 * Clears the potential surface by setting it to the neutral value.
 	 * This function does not reset the time surface.
@@ -266,7 +422,7 @@ public:
 	 * @param rectifyPolarity The new value to set
 	 */
 	void setRectifyPolarity(bool rectifyPolarity) {
-		Accumulator::rectifyPolarity_ = rectifyPolarity;
+		AccumulatorBase::rectifyPolarity_ = rectifyPolarity;
 	}
 
 	/**
@@ -276,14 +432,14 @@ public:
 	 * @param eventContribution The contribution a single event shall incur
 	 */
 	void setEventContribution(float eventContribution) {
-		Accumulator::eventContribution_ = eventContribution;
+		AccumulatorBase::eventContribution_ = eventContribution;
 	}
 
 	/**
 	 * @param maxPotential the max potential at which the surface should be capped at
 	 */
 	void setMaxPotential(float maxPotential) {
-		Accumulator::maxPotential_ = maxPotential;
+		AccumulatorBase::maxPotential_ = maxPotential;
 	}
 
 	/**
@@ -291,21 +447,21 @@ public:
 	 * Exponential decay always goes to 0. The parameter is ignored there.
 	 */
 	void setNeutralPotential(float neutralPotential) {
-		Accumulator::neutralPotential_ = neutralPotential;
+		AccumulatorBase::neutralPotential_ = neutralPotential;
 	}
 
 	/**
 	 * @param minPotential the min potential at which the surface should be capped at
 	 */
 	void setMinPotential(float minPotential) {
-		Accumulator::minPotential_ = minPotential;
+		AccumulatorBase::minPotential_ = minPotential;
 	}
 
 	/**
 	 * @param decayFunction The decay function the module should use to perform the decay
 	 */
 	void setDecayFunction(Decay decayFunction) {
-		Accumulator::decayFunction_ = decayFunction;
+		AccumulatorBase::decayFunction_ = decayFunction;
 	}
 
 	/**
@@ -313,7 +469,8 @@ public:
 	 * @param decayParam The param to be used
 	 */
 	void setDecayParam(double decayParam) {
-		Accumulator::decayParam_ = decayParam;
+		AccumulatorBase::decayParam_ = decayParam;
+		updateDecayLUT();
 	}
 
 	/**
@@ -322,7 +479,18 @@ public:
 	 * @param synchronousDecay the new value for synchronoues decay
 	 */
 	void setSynchronousDecay(bool synchronousDecay) {
-		Accumulator::synchronousDecay_ = synchronousDecay;
+		AccumulatorBase::synchronousDecay_ = synchronousDecay;
+	}
+
+	/**
+	 * Number of threads to accumulate events with. With more than one thread,
+	 * the frame is split into horizontal tiles that are accumulated
+	 * concurrently. The result is identical to serial accumulation.
+	 * @param numThreads The number of threads, 1 for serial accumulation
+	 * (default), 0 to use as many as OpenCV has threads.
+	 */
+	void setNumThreads(int numThreads) {
+		AccumulatorBase::numThreads_ = numThreads;
 	}
 
 	bool isRectifyPolarity() const {
@@ -353,6 +521,10 @@ public:
 		return decayParam_;
 	}
 
+	int getNumThreads() const {
+		return numThreads_;
+	}
+
 	const cv::Size &getShape() const {
 		return shape_;
 	}
@@ -368,8 +540,8 @@ public:
 	 * @param size The size (in pixels) of the Accumulator.
 	 * @return An accumulator object with predefined settings.
 	 */
-	static Accumulator eventFrameAccumulator(const cv::Size &size) {
-		return Accumulator(size, Accumulator::Decay::NONE, 0, false, .5, 1.0, .5, .0, false);
+	static AccumulatorBase eventFrameAccumulator(const cv::Size &size) {
+		return AccumulatorBase(size, AccumulatorBase::Decay::NONE, 0, false, .5, 1.0, .5, .0, false);
 	}
 
 	/**
@@ -381,8 +553,8 @@ public:
 	 * @param tau The tau factor for the exponential decay.
 	 * @return An accumulator object with predefined settings
 	 */
-	static Accumulator timeDecayFrameExponential(const cv::Size &size, double tau) {
-		return Accumulator(size, Accumulator::Decay::EXPONENTIAL, tau, true, 1, 1, 0, 0, true);
+	static AccumulatorBase timeDecayFrameExponential(const cv::Size &size, double tau) {
+		return AccumulatorBase(size, AccumulatorBase::Decay::EXPONENTIAL, tau, true, 1, 1, 0, 0, true);
 	}
 
 	/**
@@ -393,8 +565,8 @@ public:
 	 * @param size The size (in pixels) of the Accumulator
 	 * @return An accumulator object with predefined settings
 	 */
-	static Accumulator timeDecayFrameExponential(const cv::Size &size) {
-		return Accumulator::timeDecayFrameExponential(size, 1e6);
+	static AccumulatorBase timeDecayFrameExponential(const cv::Size &size) {
+		return AccumulatorBase::timeDecayFrameExponential(size, 1e6);
 	}
 
 	/**
@@ -406,8 +578,8 @@ public:
 	 * @param slope The slope of the linear decay
 	 * @return An accumulator object with predefined settings
 	 */
-	static Accumulator timeDecayFrameLinear(const cv::Size &size, double slope) {
-		return Accumulator(size, Accumulator::Decay::LINEAR, slope, true, 1, 1, 0, 0, true);
+	static AccumulatorBase timeDecayFrameLinear(const cv::Size &size, double slope) {
+		return AccumulatorBase(size, AccumulatorBase::Decay::LINEAR, slope, true, 1, 1, 0, 0, true);
 	}
 
 	/**
@@ -418,8 +590,8 @@ public:
 	 * @param size The size (in pixels) of the Accumulator
 	 * @return An accumulator object with predefined settings
 	 */
-	static Accumulator timeDecayFrameLinear(const cv::Size &size) {
-		return Accumulator::timeDecayFrameLinear(size, 1e-6);
+	static AccumulatorBase timeDecayFrameLinear(const cv::Size &size) {
+		return AccumulatorBase::timeDecayFrameLinear(size, 1e-6);
 	}
 
 	/**
@@ -433,9 +605,9 @@ public:
 	 * should converge
 	 * @return An accumulator with predefined settings
 	 */
-	static Accumulator reconstructionFrame(
+	static AccumulatorBase reconstructionFrame(
 		const cv::Size &size, Decay decayFunction, double decayParam, float eventContribution, float neutralPotential) {
-		return Accumulator(size, decayFunction, decayParam, false, eventContribution, 1, neutralPotential, 0, false);
+		return AccumulatorBase(size, decayFunction, decayParam, false, eventContribution, 1, neutralPotential, 0, false);
 	}
 
 	/**
@@ -446,8 +618,8 @@ public:
 	 * @param eventContribution The contribution a single event should have on the potential
 	 * @return An accumulator with predefined settings
 	 */
-	static Accumulator reconstructionFrame(const cv::Size &size, double tau, float eventContribution) {
-		return Accumulator::reconstructionFrame(size, Accumulator::Decay::EXPONENTIAL, tau, eventContribution, 0.0f);
+	static AccumulatorBase reconstructionFrame(const cv::Size &size, double tau, float eventContribution) {
+		return AccumulatorBase::reconstructionFrame(size, AccumulatorBase::Decay::EXPONENTIAL, tau, eventContribution, 0.0f);
 	}
 
 	/**
@@ -456,38 +628,232 @@ public:
 	 * @param size The size (in pixels) of the accumulator
 	 * @return An accumulator with predefined settings
 	 */
-	static Accumulator reconstructionFrame(const cv::Size &size) {
-		return Accumulator::reconstructionFrame(size, 1e6, 0.04f);
+	static AccumulatorBase reconstructionFrame(const cv::Size &size) {
+		return AccumulatorBase::reconstructionFrame(size, 1e6, 0.04f);
+	}
+};
+
+/**
+ * Accumulator storing the timestamps of the last contributions in a `TimeMat`.
+ */
+using Accumulator = AccumulatorBase<TimeMat>;
+
+/**
+ * Accumulator storing the timestamps of the last contributions in a `TimeMat32`,
+ * which halves the memory needed for them.
+ */
+using Accumulator32 = AccumulatorBase<TimeMat32>;
+
+/**
+ * Accumulates events into per-pixel event counts, optionally split by
+ * polarity and into temporal bins (voxel grid). Every event only increments
+ * an integer counter, there is no decay or clamping.
+ *
+ * The counts are stored as a CV_32S matrix with one channel per bin and
+ * polarity. With split polarities, channel `2 * bin` holds the negative and
+ * channel `2 * bin + 1` the positive events of the bin.
+ */
+class EventHistogram {
+private:
+	cv::Size shape_;
+	bool splitPolarity_ = false;
+	int temporalBins_   = 1;
+	cv::Mat counts_;
+
+	inline void count(const Event &event, int bin) {
+		const int channels = getChannels();
+		const int channel  = splitPolarity_ ? (2 * bin + (event.polarity() ? 1 : 0)) : bin;
+		counts_.ptr<int32_t>(event.y())[event.x() * channels + channel]++;
+	}
+
+public:
+	/**
+	 * Silly default constructor. This generates a histogram with zero size,
+	 * that only exists to be redefined later.
+	 */
+	EventHistogram() = default;
+
+	/**
+	 * Creates a new, empty event histogram.
+	 * @param size The size of the histogram. Must be at least the dimensions
+	 * of the event stream supposed to be added.
+	 * @param splitPolarity If true, positive and negative events are
+	 * counted in separate channels.
+	 * @param temporalBins Number of temporal bins the events are split into
+	 * by `accumulate(store, startTime, duration)`, 1 for none.
+	 */
+	EventHistogram(const cv::Size &size, bool splitPolarity, int temporalBins) :
+		shape_(size),
+		splitPolarity_(splitPolarity),
+		temporalBins_(std::max(1, temporalBins)),
+		counts_(cv::Mat(size, CV_MAKETYPE(CV_32S, getChannels()), 0.0)) {
+	}
+
+	/**
+	 * Counts all events of the store in the first temporal bin.
+	 * @param store The events to count
+	 */
+	void accumulate(const EventStore &store) {
+		store.forEachChunk([this](const Event *begin, const Event *end) {
+			for (const Event *event = begin; event < end; event++) {
+				count(*event, 0);
+			}
+		});
+	}
+
+	/**
+	 * Counts the events of the store, splitting the given time range into
+	 * equally long temporal bins. Events outside of the range are counted
+	 * in the first or last bin.
+	 * @param store The events to count
+	 * @param startTime The start of the time range of the first bin
+	 * @param duration The length of the time range covered by all bins
+	 */
+	void accumulate(const EventStore &store, time_t startTime, time_t duration) {
+		if (temporalBins_ == 1 || duration <= 0) {
+			accumulate(store);
+			return;
+		}
+
+		store.forEachChunk([this, startTime, duration](const Event *begin, const Event *end) {
+			for (const Event *event = begin; event < end; event++) {
+				const time_t bin = ((event->timestamp() - startTime) * temporalBins_) / duration;
+				count(*event, static_cast<int>(std::min<time_t>(std::max<time_t>(bin, 0), temporalBins_ - 1)));
+			}
+		});
+	}
+
+	/**
+	 * Resets all counts to zero.
+	 */
+	void clear() {
+		counts_.setTo(0);
+	}
+
+	/**
+	 * Renders the counts into the given matrix of the requested depth, in a
+	 * single saturating pass. `out` is only reallocated if it does not match
+	 * the size and type, so it can wrap existing memory.
+	 * @param out The matrix to render into, gets one channel per count channel.
+	 * @param depth The bit depth of the output, CV_8U or CV_16U.
+	 * @param saturationCount The count that maps onto the maximum output value.
+	 */
+	void generateFrame(cv::Mat &out, int depth, int saturationCount) const {
+		const double maxValue = (depth == CV_16U) ? 65535.0 : 255.0;
+		counts_.convertTo(out, CV_MAKETYPE(depth, getChannels()), maxValue / std::max(1, saturationCount));
+	}
+
+	/**
+	 * @return The raw counts, of type CV_32S with `getChannels()` channels.
+	 */
+	const cv::Mat &getCounts() const {
+		return counts_;
+	}
+
+	/**
+	 * @return The number of count channels, temporal bins times polarities
+	 */
+	int getChannels() const {
+		return temporalBins_ * (splitPolarity_ ? 2 : 1);
+	}
+
+	bool isSplitPolarity() const {
+		return splitPolarity_;
+	}
+
+	int getTemporalBins() const {
+		return temporalBins_;
+	}
+
+	const cv::Size &getShape() const {
+		return shape_;
 	}
 };
 
 /**
  * TimeSurface class that builds the surface of the occurences of the last
  * timestamps.
+ * @tparam TimeMatType The matrix type the timestamps are stored in
  */
-class TimeSurface {
+template<class TimeMatType> class TimeSurfaceBase {
 private:
-	TimeMat timeSurface;
+	TimeMatType timeSurface;
+	int numThreads = 1;
+	RowTileScheduler tileScheduler;
 
 public:
 	/**
 	 * Creates a new time surface accumulator with the given size
 	 * @param size The size (in pixels) for the time surface integrator
 	 */
-	explicit TimeSurface(const cv::Size &size) : timeSurface(TimeMat(size)) {
+	explicit TimeSurfaceBase(const cv::Size &size) : timeSurface(TimeMatType(size)) {
 	}
 
 	void accumulate(const EventStore &store) {
-		for (const Event &event : store) {
-			timeSurface.at(event.y(), event.x()) = event.timestamp();
+		if (numThreads == 1) {
+			store.forEachChunk([this](const Event *begin, const Event *end) {
+				for (const Event *event = begin; event < end; event++) {
+					timeSurface.at(event->y(), event->x()) = event->timestamp();
+				}
+			});
+		}
+		else {
+			timeSurface.ensureRepresentable(store.getHighestTime());
+			tileScheduler.forEachEvent(store, timeSurface.rows, numThreads,
+				[this](const Event &event) { timeSurface.at(event.y(), event.x()) = event.timestamp(); });
 		}
 	}
 
+	/**
+	 * Adds a single event to the time surface.
+	 * @param event The event to add
+	 */
+	void accumulate(const Event &event) {
+		timeSurface.at(event.y(), event.x()) = event.timestamp();
+	}
+
+	/**
+	 * Evaluates the exponentially decaying time surface (surface of active
+	 * events) at the given time. Every pixel is set to `e^((t_{last} - time) / tau)`,
+	 * pixels without events are set to 0 and pixels with events newer than
+	 * `time` to 1. The exponential function is evaluated on the whole surface
+	 * at once with OpenCV's vectorized `cv::exp`.
+	 * @param time The time at which to evaluate the surface
+	 * @param tau The time constant of the decay
+	 * @param out The resulting surface of type CV_32F, with values from 0 to 1.
+	 * Its memory is reused if it already has the right size and type.
+	 */
+	void generateExponentialDecay(time_t time, double tau, cv::Mat &out) const {
+		out.create(timeSurface.size(), CV_32F);
+
+		const auto scale = (float) (-1.0 / tau);
+		for (coord_t r = 0; r < timeSurface.rows; r++) {
+			float *exponent = out.ptr<float>(r);
+			for (coord_t c = 0; c < timeSurface.cols; c++) {
+				const time_t last = timeSurface.at(r, c);
+				// exp(-100) is below the resolution of any frame format
+				exponent[c] = (last == 0) ? -100.0f : (float) std::max<time_t>(time - last, 0) * scale;
+			}
+		}
+		cv::exp(out, out);
+	}
+
+	/**
+	 * Number of threads to accumulate events with. With more than one thread,
+	 * the surface is split into horizontal tiles that are updated
+	 * concurrently. The result is identical to serial accumulation.
+	 * @param threads The number of threads, 1 for serial accumulation
+	 * (default), 0 to use as many as OpenCV has threads.
+	 */
+	void setNumThreads(int threads) {
+		numThreads = threads;
+	}
+
 	/**
 	 * Returns the current time surface
 	 * @return An OpenCV Matrix containing the current time surface.
 	 */
-	const TimeMat &getTimeSurface() const {
+	const TimeMatType &getTimeSurface() const {
 		return timeSurface;
 	}
 
@@ -503,6 +869,16 @@ public:
 	}
 };
 
+/**
+ * TimeSurface storing the timestamps in a `TimeMat`.
+ */
+using TimeSurface = TimeSurfaceBase<TimeMat>;
+
+/**
+ * TimeSurface storing the timestamps in the more compact `TimeMat32`.
+ */
+using TimeSurface32 = TimeSurfaceBase<TimeMat32>;
+
 } // namespace dv
 
 #endif // DV_PROCESSING_FRAME_HPP
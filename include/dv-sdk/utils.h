@@ -50,6 +50,13 @@ template<typename T> unique_ptr_void make_unique_void(T *ptr) {
 
 using logLevel = libcaer::log::logLevel;
 
+// Logger of the calling thread, used by dvLog(). Modules can pass theirs on
+// to threads they start themselves, so these log with the module's prefix.
+struct LogBlock;
+
+void LoggerSet(const LogBlock *logger);
+const LogBlock *LoggerGet();
+
 template<typename... Args> static inline void Log(logLevel level, const char *format, Args &&... args) {
 #	pragma GCC diagnostic push
 #	pragma GCC diagnostic ignored "-Wformat-nonliteral"
@@ -5,7 +5,14 @@ class Accumulator : public dv::ModuleBase {
 private:
 	dv::EventStreamSlicer slicer;
 	dv::Accumulator frameAccumulator;
+	dv::EventHistogram histogram;
 	dv::slicejob_t sliceJob;
+	// Reused buffer for multi-channel histograms before mapping to color.
+	cv::Mat histogramPixels;
+	// Configuration, read on every frame.
+	dv::ConfigHandle<dv::CfgType::STRING> accumulationMode;
+	dv::ConfigHandle<dv::CfgType::INT> accumulationTime;
+	dv::ConfigHandle<dv::CfgType::INT> countSaturation;
 
 public:
 	static const char *getDescription() {
@@ -35,35 +42,122 @@ public:
 		config.add("synchronousDecay", dv::ConfigOption::boolOption("Decay at frame generation time"));
 		config.add(
 			"accumulationTime", dv::ConfigOption::intOption("Time in ms to accumulate events over", 33, 1, 1000));
+		config.add("numThreads",
+			dv::ConfigOption::intOption("Number of threads to accumulate events with, 0 for automatic", 1, 0, 64));
+		config.add("accumulationMode",
+			dv::ConfigOption::listOption(
+				"Potential: decaying potential surface. EventCount: number of events per pixel. PolarityHistogram: "
+				"number of negative (blue) and positive (red) events per pixel. VoxelGrid: number of events per "
+				"pixel in equally long temporal bins of the accumulation time, in color channels (oldest first)",
+				0, {"Potential", "EventCount", "PolarityHistogram", "VoxelGrid"}));
+		config.add("voxelBins", dv::ConfigOption::intOption("Number of temporal bins in VoxelGrid mode", 3, 2, 4));
+		config.add("countSaturation",
+			dv::ConfigOption::intOption(
+				"Event count per pixel mapped to full brightness in the histogram modes", 8, 1, 65535));
+		config.add("frameTimeout",
+			dv::ConfigOption::intOption(
+				"Time in ms (wall-clock) after which a frame is generated even without new events, 0 to disable", 0,
+				0, 10000));
 	}
 
 	void doPerFrameTime(const dv::EventStore &events) {
+		if (accumulationMode.get() != "Potential") {
+			doPerFrameHistogram(events);
+			return;
+		}
+
 		frameAccumulator.accumulate(events);
-		// generate frame
-		auto frame = frameAccumulator.generateFrame();
 
-		// make sure frame is in correct exposure and data type
-		double scaleFactor
-			= 255.0 / static_cast<double>(frameAccumulator.getMaxPotential() - frameAccumulator.getMinPotential());
-		double shiftFactor = -static_cast<double>(frameAccumulator.getMinPotential()) * scaleFactor;
-		cv::Mat correctedFrame;
-		frame.convertTo(correctedFrame, CV_8U, scaleFactor, shiftFactor);
+		// render the frame in correct exposure and data type directly into the output
+		auto frame          = outputs.getFrameOutput("frames").frame();
+		cv::Mat framePixels = frame.getMat(static_cast<int16_t>(frameAccumulator.getShape().width),
+			static_cast<int16_t>(frameAccumulator.getShape().height));
+		frameAccumulator.generateFrame(framePixels);
 
 		// output
-		outputs.getFrameOutput("frames") << correctedFrame;
+		frame.commit();
+	}
+
+	void doPerFrameHistogram(const dv::EventStore &events) {
+		if (histogram.getTemporalBins() > 1 && !events.isEmpty()) {
+			// bins cover the accumulation time up to (and including) the newest event
+			const dv::time_t duration = accumulationTime.get() * 1000;
+			histogram.accumulate(events, events.getHighestTime() - duration + 1, duration);
+		}
+		else {
+			histogram.accumulate(events);
+		}
+
+		const auto sizeX       = static_cast<int16_t>(histogram.getShape().width);
+		const auto sizeY       = static_cast<int16_t>(histogram.getShape().height);
+		const int saturation   = countSaturation.get();
+		const int channels     = histogram.getChannels();
+		auto frame             = outputs.getFrameOutput("frames").frame();
+		const auto frameFormat = (channels == 1)   ? dv::FrameFormat::GRAY
+								 : (channels == 4) ? dv::FrameFormat::BGRA
+												   : dv::FrameFormat::BGR;
+		cv::Mat framePixels    = frame.getMat(sizeX, sizeY, frameFormat);
+
+		if (channels == 2) {
+			// two channels map to blue (first) and red (second), green stays empty
+			histogram.generateFrame(histogramPixels, CV_8U, saturation);
+			const int fromTo[] = {0, 0, -1, 1, 1, 2};
+			cv::mixChannels(&histogramPixels, 1, &framePixels, 1, fromTo, 3);
+		}
+		else {
+			histogram.generateFrame(framePixels, CV_8U, saturation);
+		}
+
+		if (!events.isEmpty()) {
+			frame->timestamp = events.getHighestTime();
+		}
+
+		frame.commit();
+		histogram.clear();
+	}
+
+	void updateHistogram() {
+		const std::string mode = config.getString("accumulationMode");
+		const bool split       = (mode == "PolarityHistogram");
+		const int bins         = (mode == "VoxelGrid") ? config.getInt("voxelBins") : 1;
+
+		if (histogram.getShape() != inputs.getEventInput("events").size() || histogram.isSplitPolarity() != split
+			|| histogram.getTemporalBins() != bins) {
+			histogram = dv::EventHistogram(inputs.getEventInput("events").size(), split, bins);
+		}
 	}
 
 	Accumulator() : slicer(dv::EventStreamSlicer()) {
 		outputs.getFrameOutput("frames").setup(inputs.getEventInput("events"));
+
+		accumulationMode = config.handle<dv::CfgType::STRING>("accumulationMode");
+		accumulationTime = config.handle<dv::CfgType::INT>("accumulationTime");
+		countSaturation  = config.handle<dv::CfgType::INT>("countSaturation");
+
 		frameAccumulator = dv::Accumulator::reconstructionFrame(inputs.getEventInput("events").size());
+		updateHistogram();
 
 		sliceJob = slicer.doEveryTimeInterval(config.getInt("accumulationTime") * 1000,
 			std::function<void(const dv::EventStore &)>(
 				std::bind(&Accumulator::doPerFrameTime, this, std::placeholders::_1)));
+		setFrameTimeout(config.getInt("frameTimeout"));
+	}
+
+	void setFrameTimeout(int timeoutMs) {
+		slicer.modifyClockTimeout(sliceJob, timeoutMs * 1000);
+		setRunTimeout(std::chrono::milliseconds(timeoutMs));
 	}
 
 	void run() override {
-		slicer.addEventPacket(inputs.getEventInput("events").events());
+		auto events = inputs.getEventInput("events").events();
+
+		// run() is also invoked by the run timeout, without new events
+		if (events) {
+			slicer.addEventPacket(events);
+		}
+		else {
+			slicer.evaluate();
+		}
 	}
 
 	static dv::Accumulator::Decay decayFromString(const std::string &name) {
@@ -85,7 +179,10 @@ public:
 		frameAccumulator.setDecayFunction(decayFromString(config.getString("decayFunction")));
 		frameAccumulator.setDecayParam(config.getDouble("decayParam"));
 		frameAccumulator.setSynchronousDecay(config.getBool("synchronousDecay"));
+		frameAccumulator.setNumThreads(config.getInt("numThreads"));
+		updateHistogram();
 		slicer.modifyTimeInterval(sliceJob, config.getInt("accumulationTime") * 1000);
+		setFrameTimeout(config.getInt("frameTimeout"));
 	}
 };
 
@@ -1,8 +1,9 @@
-#define DV_API_OPENCV_SUPPORT 0
-#include "dv-sdk/data/event.hpp"
 #include "dv-sdk/module.hpp"
+#include "dv-sdk/processing/event.hpp"
 
 #include <array>
+#include <boost/range/counting_range.hpp>
+#include <fstream>
 #include <vector>
 
 namespace dvCfg  = dv::Config;
@@ -19,6 +20,44 @@ struct pixel_with_count {
 #define GET_POL(X) ((X) &0x01)
 #define SET_TSPOL(TS, POL) (((TS) << 1) | ((POL) &0x01))
 
+// Rows bordering a tile that are needed to filter it: the direct neighbors, and
+// their neighbors for two-level background activity filtering.
+#define TILE_HALO 2
+
+// Timestamps are stored as 31-bit offsets from an epoch, together with the
+// polarity. The margin between the epoch and new events is larger than any
+// filter time.
+#define TIMESTAMPS_MAX_OFFSET ((INT64_C(1) << 31) - 1)
+#define TIMESTAMPS_EPOCH_MARGIN (INT64_C(1) << 28)
+
+enum class EventState : uint8_t {
+	VALID,
+	HOT_PIXEL,
+	REFRACTORY_PERIOD,
+	BACKGROUND_ACTIVITY,
+};
+
+struct FilterSettings {
+	bool refractoryPeriodEnabled;
+	int32_t refractoryPeriodTime;
+	bool backgroundActivityEnabled;
+	int32_t backgroundActivitySupportMin;
+	int32_t backgroundActivitySupportMax;
+	int32_t backgroundActivityTime;
+	bool backgroundActivityCheckPolarity;
+	bool backgroundActivityTwoLevels;
+};
+
+// Horizontal stripe of the timestamps map, can be filtered independently.
+struct TimestampTile {
+	int16_t rowStart;                   // First row owned by this tile.
+	int16_t rowEnd;                     // One past the last row owned by this tile.
+	int16_t haloStart;                  // First row stored in the map, including halo.
+	int16_t haloEnd;                    // One past the last row stored in the map, including halo.
+	std::vector<uint32_t> map;          // Timestamps of rows [haloStart, haloEnd).
+	std::vector<uint32_t> eventIndexes; // Events of the current packet in rows [haloStart, haloEnd).
+};
+
 class DVSNoiseFilter : public dv::ModuleBase {
 private:
 	// Hot Pixel filter (learning).
@@ -27,10 +66,11 @@ private:
 	std::vector<int32_t> hotPixelLearningMap;
 	// Hot Pixel filter (filtering).
 	std::vector<pixel_with_count> hotPixelArray;
+	std::vector<uint8_t> hotPixelMap; // Dense per-pixel flag, for a single lookup per event.
 	int64_t hotPixelStatOn;
 	int64_t hotPixelStatOff;
 	// Background Activity filter.
-	std::array<size_t, 8> supportPixelIndexes;
+	dv::CorrelationFilter32 correlationFilter;
 	int64_t backgroundActivityStatOn;
 	int64_t backgroundActivityStatOff;
 	// Refractory Period filter.
@@ -39,7 +79,26 @@ private:
 	// Maps and their sizes.
 	int16_t sizeX;
 	int16_t sizeY;
-	std::vector<int64_t> timestampsMap;
+	int64_t timestampsEpoch;
+	std::vector<TimestampTile> tiles;
+	std::vector<uint16_t> rowTiles; // Index of the tile owning each row.
+	std::vector<EventState> eventStates;
+	// Configuration, read on every packet.
+	dv::ConfigHandle<dvCfgType::BOOL> hotPixelEnable;
+	dv::ConfigHandle<dvCfgType::BOOL> hotPixelLearn;
+	dv::ConfigHandle<dvCfgType::BOOL> hotPixelLearnContinuous;
+	dv::ConfigHandle<dvCfgType::INT> hotPixelTime;
+	dv::ConfigHandle<dvCfgType::BOOL> refractoryPeriodEnable;
+	dv::ConfigHandle<dvCfgType::INT> refractoryPeriodTime;
+	dv::ConfigHandle<dvCfgType::BOOL> backgroundActivityEnable;
+	dv::ConfigHandle<dvCfgType::INT> backgroundActivitySupportMin;
+	dv::ConfigHandle<dvCfgType::INT> backgroundActivitySupportMax;
+	dv::ConfigHandle<dvCfgType::INT> backgroundActivityTime;
+	dv::ConfigHandle<dvCfgType::BOOL> backgroundActivityCheckPolarity;
+	dv::ConfigHandle<dvCfgType::BOOL> backgroundActivityTwoLevels;
+	dv::ConfigHandle<dvCfgType::STRING> backgroundActivityAlgorithm;
+	dv::ConfigHandle<dvCfgType::INT> backgroundActivitySubsample;
+	dv::ConfigHandle<dvCfgType::INT> numThreads;
 
 public:
 	static void addInputs(dv::InputDefinitionList &in) {
@@ -66,6 +125,15 @@ public:
 			"hotPixelCount", dv::ConfigOption::intOption(
 								 "Number of events needed in a learning time period for a pixel to be considered hot.",
 								 10000, 0, 10000000));
+		config.add("hotPixelLearnContinuous",
+			dv::ConfigOption::boolOption(
+				"Continuously re-learn the hot pixels in the background, replacing the current set at the end of "
+				"every learning time period."));
+		config.add("hotPixelFile",
+			dv::ConfigOption::fileSaveOption(
+				"File to persist the learned hot pixels in. Loaded at start-up and updated after every learning "
+				"period. Leave empty to disable.",
+				"txt"));
 		config.add("hotPixelFilteredOn",
 			dv::ConfigOption::statisticOption("Number of ON events filtered out by the hot pixel filter."));
 		config.add("hotPixelFilteredOff",
@@ -89,6 +157,15 @@ public:
 			dv::ConfigOption::intOption(
 				"Maximum time difference in µs for events to be considered correlated and not be filtered out.", 2000,
 				0, 10000000));
+		config.add("backgroundActivityAlgorithm",
+			dv::ConfigOption::listOption(
+				"Neighbors: check the last timestamps of the eight neighboring pixels. Correlation: check the last "
+				"timestamps of the eight neighboring cells of 2^backgroundActivitySubsample pixels per side, with "
+				"less memory and constant cost per event; two levels and maximum support do not apply.",
+				0, {"Neighbors", "Correlation"}));
+		config.add("backgroundActivitySubsample",
+			dv::ConfigOption::intOption(
+				"Correlation algorithm: cells are 2^N pixels per side, N = 0 for single pixels.", 0, 0, 4));
 		config.add("backgroundActivityFilteredOn",
 			dv::ConfigOption::statisticOption("Number of ON events filtered out by the background activity filter."));
 		config.add("backgroundActivityFilteredOff",
@@ -102,6 +179,11 @@ public:
 			dv::ConfigOption::statisticOption("Number of ON events filtered out by the refractory period filter."));
 		config.add("refractoryPeriodFilteredOff",
 			dv::ConfigOption::statisticOption("Number of OFF events filtered out by the refractory period filter."));
+
+		config.add("numThreads",
+			dv::ConfigOption::intOption(
+				"Number of threads to run the refractory period and background activity filters with, 0 for automatic.",
+				1, 0, 64));
 	}
 
 	DVSNoiseFilter() :
@@ -112,13 +194,39 @@ public:
 		backgroundActivityStatOn(0),
 		backgroundActivityStatOff(0),
 		refractoryPeriodStatOn(0),
-		refractoryPeriodStatOff(0) {
+		refractoryPeriodStatOff(0),
+		timestampsEpoch(0) {
 		auto eventInput = inputs.getEventInput("events");
 
 		sizeX = static_cast<int16_t>(eventInput.sizeX());
 		sizeY = static_cast<int16_t>(eventInput.sizeY());
 
-		timestampsMap.resize(static_cast<size_t>(sizeX * sizeY));
+		hotPixelMap.resize(static_cast<size_t>(sizeX * sizeY));
+		rowTiles.resize(static_cast<size_t>(sizeY));
+
+		hotPixelEnable                  = config.handle<dvCfgType::BOOL>("hotPixelEnable");
+		hotPixelLearn                   = config.handle<dvCfgType::BOOL>("hotPixelLearn");
+		hotPixelLearnContinuous         = config.handle<dvCfgType::BOOL>("hotPixelLearnContinuous");
+		hotPixelTime                    = config.handle<dvCfgType::INT>("hotPixelTime");
+		refractoryPeriodEnable          = config.handle<dvCfgType::BOOL>("refractoryPeriodEnable");
+		refractoryPeriodTime            = config.handle<dvCfgType::INT>("refractoryPeriodTime");
+		backgroundActivityEnable        = config.handle<dvCfgType::BOOL>("backgroundActivityEnable");
+		backgroundActivitySupportMin    = config.handle<dvCfgType::INT>("backgroundActivitySupportMin");
+		backgroundActivitySupportMax    = config.handle<dvCfgType::INT>("backgroundActivitySupportMax");
+		backgroundActivityTime          = config.handle<dvCfgType::INT>("backgroundActivityTime");
+		backgroundActivityCheckPolarity = config.handle<dvCfgType::BOOL>("backgroundActivityCheckPolarity");
+		backgroundActivityTwoLevels     = config.handle<dvCfgType::BOOL>("backgroundActivityTwoLevels");
+		backgroundActivityAlgorithm     = config.handle<dvCfgType::STRING>("backgroundActivityAlgorithm");
+		backgroundActivitySubsample     = config.handle<dvCfgType::INT>("backgroundActivitySubsample");
+		numThreads                      = config.handle<dvCfgType::INT>("numThreads");
+
+		correlationFilter = dv::CorrelationFilter32(cv::Size(sizeX, sizeY), backgroundActivityTime.get(),
+			backgroundActivitySupportMin.get(), backgroundActivitySubsample.get(),
+			backgroundActivityCheckPolarity.get());
+
+		updateTiles(numThreads.get());
+
+		hotPixelLoadFile();
 
 		// Populate event output info node, keep same as input info node.
 		outputs.getEventOutput("events").setup(inputs.getEventInput("events"));
@@ -128,32 +236,59 @@ public:
 		auto evt_in  = inputs.getEventInput("events").events();
 		auto evt_out = outputs.getEventOutput("events").events();
 
-		bool hotPixelEnabled           = config.get<dvCfgType::BOOL>("hotPixelEnable");
-		bool refractoryPeriodEnabled   = config.get<dvCfgType::BOOL>("refractoryPeriodEnable");
-		bool backgroundActivityEnabled = config.get<dvCfgType::BOOL>("backgroundActivityEnable");
+		const bool hotPixelEnabled = hotPixelEnable.get();
+
+		FilterSettings settings;
+		settings.refractoryPeriodEnabled         = refractoryPeriodEnable.get();
+		settings.refractoryPeriodTime            = refractoryPeriodTime.get();
+		settings.backgroundActivityEnabled       = backgroundActivityEnable.get();
+		settings.backgroundActivitySupportMin    = backgroundActivitySupportMin.get();
+		settings.backgroundActivitySupportMax    = backgroundActivitySupportMax.get();
+		settings.backgroundActivityTime          = backgroundActivityTime.get();
+		settings.backgroundActivityCheckPolarity = backgroundActivityCheckPolarity.get();
+		settings.backgroundActivityTwoLevels     = backgroundActivityTwoLevels.get();
+
+		// The correlation algorithm keeps its own state and runs after the tiles.
+		const bool correlationEnabled
+			= settings.backgroundActivityEnabled && (backgroundActivityAlgorithm.get() == "Correlation");
+
+		if (correlationEnabled) {
+			settings.backgroundActivityEnabled = false;
+
+			correlationFilter.setCorrelationTime(settings.backgroundActivityTime);
+			correlationFilter.setSupportMin(settings.backgroundActivitySupportMin);
+			correlationFilter.setSubsample(backgroundActivitySubsample.get());
+			correlationFilter.setSplitPolarity(settings.backgroundActivityCheckPolarity);
+		}
 
-		int32_t hotPixelTime                 = config.get<dvCfgType::INT>("hotPixelTime");
-		int32_t refractoryPeriodTime         = config.get<dvCfgType::INT>("refractoryPeriodTime");
-		int32_t backgroundActivitySupportMin = config.get<dvCfgType::INT>("backgroundActivitySupportMin");
-		int32_t backgroundActivitySupportMax = config.get<dvCfgType::INT>("backgroundActivitySupportMax");
-		int32_t backgroundActivityTime       = config.get<dvCfgType::INT>("backgroundActivityTime");
-		bool backgroundActivityCheckPolarity = config.get<dvCfgType::BOOL>("backgroundActivityCheckPolarity");
-		bool backgroundActivityTwoLevels     = config.get<dvCfgType::BOOL>("backgroundActivityTwoLevels");
+		const dv::Event *events   = evt_in.data();
+		const size_t eventsNumber = evt_in.size();
 
 		// Hot Pixel learning: initialize and store packet-level timestamp.
-		if (config.get<dvCfgType::BOOL>("hotPixelLearn") && !hotPixelLearningStarted) {
+		if ((hotPixelLearn.get() || hotPixelLearnContinuous.get()) && !hotPixelLearningStarted && (eventsNumber > 0)) {
 			// Initialize hot pixel learning.
-			hotPixelLearningMap.resize(static_cast<size_t>(sizeX * sizeY));
+			hotPixelLearningMap.assign(static_cast<size_t>(sizeX * sizeY), 0);
 
 			hotPixelLearningStarted = true;
 
 			// Store start timestamp.
-			hotPixelLearningStartTime = evt_in[0].timestamp();
+			hotPixelLearningStartTime = events[0].timestamp();
 
 			log.debug << "HotPixel Learning: started on ts=" << hotPixelLearningStartTime << "." << dv::logEnd;
 		}
 
-		for (const auto &evt : evt_in) {
+		updateTimestampsEpoch(events, eventsNumber);
+		updateTiles(numThreads.get());
+
+		eventStates.resize(eventsNumber);
+
+		for (auto &tile : tiles) {
+			tile.eventIndexes.clear();
+		}
+
+		for (size_t i = 0; i < eventsNumber; i++) {
+			const auto &evt = events[i];
+
 			size_t pixelIndex = static_cast<size_t>((evt.y() * sizeX) + evt.x()); // Target pixel.
 
 			// Hot Pixel learning: determine which pixels are abnormally active,
@@ -164,13 +299,17 @@ public:
 			if (hotPixelLearningStarted) {
 				hotPixelLearningMap[pixelIndex]++;
 
-				if (evt.timestamp() > (hotPixelLearningStartTime + hotPixelTime)) {
+				if (evt.timestamp() > (hotPixelLearningStartTime + hotPixelTime.get())) {
 					// Enough time has passed, we can proceed with data evaluation.
 					hotPixelGenerateArray();
+					hotPixelSaveFile();
 
-					// Done, reset and notify end of learning.
-					hotPixelLearningMap.clear();
-					hotPixelLearningMap.shrink_to_fit();
+					// Done, reset and notify end of learning. In continuous mode
+					// the next learning period starts with the next packet.
+					if (!hotPixelLearnContinuous.get()) {
+						hotPixelLearningMap.clear();
+						hotPixelLearningMap.shrink_to_fit();
+					}
 
 					hotPixelLearningStarted = false;
 
@@ -181,94 +320,95 @@ public:
 			}
 
 			// Hot Pixel filter: filter out abnormally active pixels by their address.
-			if (hotPixelEnabled) {
-				bool filteredOut = std::any_of(hotPixelArray.cbegin(), hotPixelArray.cend(),
-					[&evt](const auto &px) { return ((evt.x() == px.x) && (evt.y() == px.y)); });
+			if (hotPixelEnabled && hotPixelMap[pixelIndex]) {
+				// Don't execute other filters and don't update timestamps map.
+				// Hot pixels don't provide any useful timing information, as
+				// they are repeating noise.
+				eventStates[i] = EventState::HOT_PIXEL;
+				continue;
+			}
 
-				if (filteredOut) {
-					if (evt.polarity()) {
-						hotPixelStatOn++;
-					}
-					else {
-						hotPixelStatOff++;
-					}
+			eventStates[i] = EventState::VALID;
 
-					// Go to next event, don't execute other filters and don't
-					// update timestamps map. Hot pixels don't provide any useful
-					// timing information, as they are repeating noise.
+			// Hand the event to all tiles that contain its row, either as their
+			// own or as halo row. A single tile just takes all events.
+			if (tiles.size() == 1) {
+				continue;
+			}
+
+			const size_t firstTile = rowTiles[static_cast<size_t>(std::max(evt.y() - TILE_HALO, 0))];
+			const size_t lastTile  = rowTiles[static_cast<size_t>(std::min(evt.y() + TILE_HALO, sizeY - 1))];
+
+			for (size_t tile = firstTile; tile <= lastTile; tile++) {
+				tiles[tile].eventIndexes.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		// Refractory Period and Background Activity filters: every tile only
+		// accesses its own timestamps, so they can all run in parallel.
+		exchangeTileHalos();
+
+		auto filterTileFunction
+			= [this, events, &settings](size_t tileIndex) { filterTile(tiles[tileIndex], events, settings); };
+
+		if (tiles.size() == 1) {
+			filterTileFunction(0);
+		}
+		else {
+			cv::parallel_for_(cv::Range(0, static_cast<int>(tiles.size())),
+				dv::ParallelIndexLoopBody<decltype(filterTileFunction)>(filterTileFunction),
+				static_cast<double>(tiles.size()));
+		}
+
+		if (correlationEnabled) {
+			for (size_t i = 0; i < eventsNumber; i++) {
+				if (eventStates[i] == EventState::HOT_PIXEL) {
 					continue;
 				}
+
+				// Always update the correlation state, like the timestamps map.
+				if (!correlationFilter.accept(events[i]) && (eventStates[i] == EventState::VALID)) {
+					eventStates[i] = EventState::BACKGROUND_ACTIVITY;
+				}
 			}
+		}
 
-			// Refractory Period filter.
-			// Execute before BAFilter, as this is a much simpler check, so if we
-			// can we try to eliminate the event early in a less costly manner.
-			if (refractoryPeriodEnabled) {
-				if ((evt.timestamp() - GET_TS(timestampsMap[pixelIndex])) < refractoryPeriodTime) {
+		// Output valid events in their original order and update statistics.
+		for (size_t i = 0; i < eventsNumber; i++) {
+			const auto &evt = events[i];
+
+			switch (eventStates[i]) {
+				case EventState::VALID:
+					evt_out.emplace_back(evt);
+					break;
+
+				case EventState::HOT_PIXEL:
 					if (evt.polarity()) {
-						refractoryPeriodStatOn++;
+						hotPixelStatOn++;
 					}
 					else {
-						refractoryPeriodStatOff++;
+						hotPixelStatOff++;
 					}
+					break;
 
-					// Invalid, jump.
-					goto WriteTimestamp;
-				}
-			}
-
-			if (backgroundActivityEnabled) {
-				size_t supportPixelNum
-					= doBackgroundActivityLookup(evt.x(), evt.y(), pixelIndex, evt.timestamp(), evt.polarity(),
-						supportPixelIndexes.data(), backgroundActivityTime, backgroundActivityCheckPolarity);
-
-				bool filteredOut = true;
-
-				if ((supportPixelNum >= static_cast<size_t>(backgroundActivitySupportMin))
-					&& (supportPixelNum <= static_cast<size_t>(backgroundActivitySupportMax))) {
-					if (backgroundActivityTwoLevels) {
-						// Do the check again for all previously discovered supporting pixels.
-						for (size_t i = 0; i < supportPixelNum; i++) {
-							size_t supportPixelIndex = supportPixelIndexes[i];
-							int16_t supportPixelX
-								= static_cast<int16_t>(supportPixelIndex % static_cast<size_t>(sizeX));
-							int16_t supportPixelY
-								= static_cast<int16_t>(supportPixelIndex / static_cast<size_t>(sizeX));
-
-							if (doBackgroundActivityLookup(supportPixelX, supportPixelY, supportPixelIndex,
-									evt.timestamp(), evt.polarity(), nullptr, backgroundActivityTime,
-									backgroundActivityCheckPolarity)
-								> 0) {
-								filteredOut = false;
-								break;
-							}
-						}
+				case EventState::REFRACTORY_PERIOD:
+					if (evt.polarity()) {
+						refractoryPeriodStatOn++;
 					}
 					else {
-						filteredOut = false;
+						refractoryPeriodStatOff++;
 					}
-				}
+					break;
 
-				if (filteredOut) {
+				case EventState::BACKGROUND_ACTIVITY:
 					if (evt.polarity()) {
 						backgroundActivityStatOn++;
 					}
 					else {
 						backgroundActivityStatOff++;
 					}
-
-					// Invalid, jump.
-					goto WriteTimestamp;
-				}
+					break;
 			}
-
-			// Valid event.
-			evt_out.emplace_back(evt);
-
-		WriteTimestamp:
-			// Update pixel timestamp (one write). Always update so filters are
-			// ready at enable-time right away.
-			timestampsMap[pixelIndex] = SET_TSPOL(evt.timestamp(), evt.polarity());
 		}
 
 		evt_out.commit();
@@ -282,8 +422,203 @@ public:
 		config.set<dvCfgType::LONG>("refractoryPeriodFilteredOff", refractoryPeriodStatOff);
 	}
 
-	inline size_t doBackgroundActivityLookup(int16_t x, int16_t y, size_t pixelIndex, int64_t timestamp, bool polarity,
-		size_t *supportIndexes, int32_t backgroundActivityTime, bool backgroundActivityCheckPolarity) {
+	/**
+	 * Run the Refractory Period and Background Activity filters on the events
+	 * of a tile, in stream order. Events in the halo rows only update the
+	 * timestamps, they are filtered by the tile owning their row.
+	 */
+	void filterTile(TimestampTile &tile, const dv::Event *events, const FilterSettings &settings) {
+		if (tiles.size() == 1) {
+			filterTileEvents(tile, events, settings, boost::counting_range(size_t{0}, eventStates.size()));
+		}
+		else {
+			filterTileEvents(tile, events, settings, tile.eventIndexes);
+		}
+	}
+
+	template<typename Indexes>
+	void filterTileEvents(
+		TimestampTile &tile, const dv::Event *events, const FilterSettings &settings, const Indexes &eventIndexes) {
+		std::array<size_t, 8> supportPixelIndexes;
+
+		for (const auto eventIndex : eventIndexes) {
+			// Multiple tiles only get the events not filtered as hot pixels.
+			if ((tiles.size() == 1) && (eventStates[eventIndex] == EventState::HOT_PIXEL)) {
+				continue;
+			}
+
+			const auto &evt = events[eventIndex];
+
+			size_t pixelIndex = static_cast<size_t>(((evt.y() - tile.haloStart) * sizeX) + evt.x());
+			int64_t timestamp = evt.timestamp() - timestampsEpoch;
+
+			if ((evt.y() >= tile.rowStart) && (evt.y() < tile.rowEnd)) {
+				eventStates[eventIndex]
+					= filterEvent(tile, evt, pixelIndex, timestamp, settings, supportPixelIndexes.data());
+			}
+
+			// Update pixel timestamp (one write). Always update so filters are
+			// ready at enable-time right away.
+			tile.map[pixelIndex] = static_cast<uint32_t>(SET_TSPOL(timestamp, evt.polarity()));
+		}
+	}
+
+	EventState filterEvent(const TimestampTile &tile, const dv::Event &evt, size_t pixelIndex, int64_t timestamp,
+		const FilterSettings &settings, size_t *supportPixelIndexes) const {
+		// Refractory Period filter.
+		// Execute before BAFilter, as this is a much simpler check, so if we
+		// can we try to eliminate the event early in a less costly manner.
+		if (settings.refractoryPeriodEnabled) {
+			if ((timestamp - GET_TS(tile.map[pixelIndex])) < settings.refractoryPeriodTime) {
+				return (EventState::REFRACTORY_PERIOD);
+			}
+		}
+
+		if (settings.backgroundActivityEnabled) {
+			size_t supportPixelNum = doBackgroundActivityLookup(tile, evt.x(), evt.y(), pixelIndex, timestamp,
+				evt.polarity(), supportPixelIndexes, settings.backgroundActivityTime,
+				settings.backgroundActivityCheckPolarity);
+
+			bool filteredOut = true;
+
+			if ((supportPixelNum >= static_cast<size_t>(settings.backgroundActivitySupportMin))
+				&& (supportPixelNum <= static_cast<size_t>(settings.backgroundActivitySupportMax))) {
+				if (settings.backgroundActivityTwoLevels) {
+					// Do the check again for all previously discovered supporting pixels.
+					for (size_t i = 0; i < supportPixelNum; i++) {
+						size_t supportPixelIndex = supportPixelIndexes[i];
+						int16_t supportPixelX = static_cast<int16_t>(supportPixelIndex % static_cast<size_t>(sizeX));
+						int16_t supportPixelY = static_cast<int16_t>(
+							(supportPixelIndex / static_cast<size_t>(sizeX)) + static_cast<size_t>(tile.haloStart));
+
+						if (doBackgroundActivityLookup(tile, supportPixelX, supportPixelY, supportPixelIndex, timestamp,
+								evt.polarity(), nullptr, settings.backgroundActivityTime,
+								settings.backgroundActivityCheckPolarity)
+							> 0) {
+							filteredOut = false;
+							break;
+						}
+					}
+				}
+				else {
+					filteredOut = false;
+				}
+			}
+
+			if (filteredOut) {
+				return (EventState::BACKGROUND_ACTIVITY);
+			}
+		}
+
+		return (EventState::VALID);
+	}
+
+	/**
+	 * Keep all timestamps of the current packet representable as 31-bit
+	 * offsets from the epoch. When the epoch has to move, stored timestamps
+	 * older than the new epoch are clamped to it: they are further back than
+	 * any filter time, so all comparisons keep their result.
+	 */
+	void updateTimestampsEpoch(const dv::Event *events, size_t eventsNumber) {
+		if (eventsNumber == 0) {
+			return;
+		}
+
+		const int64_t lowestTimestamp  = events[0].timestamp();
+		const int64_t highestTimestamp = events[eventsNumber - 1].timestamp();
+		const int64_t newEpoch         = std::max(lowestTimestamp - TIMESTAMPS_EPOCH_MARGIN, INT64_C(0));
+
+		if (lowestTimestamp < timestampsEpoch) {
+			// Time went backwards (reset), old timestamps are meaningless.
+			for (auto &tile : tiles) {
+				std::fill(tile.map.begin(), tile.map.end(), 0);
+			}
+
+			timestampsEpoch = newEpoch;
+		}
+		else if ((highestTimestamp - timestampsEpoch) > TIMESTAMPS_MAX_OFFSET) {
+			const int64_t shift = newEpoch - timestampsEpoch;
+
+			for (auto &tile : tiles) {
+				for (auto &entry : tile.map) {
+					entry = (GET_TS(entry) > shift)
+								? static_cast<uint32_t>(SET_TSPOL(GET_TS(entry) - shift, GET_POL(entry)))
+								: 0;
+				}
+			}
+
+			timestampsEpoch = newEpoch;
+		}
+	}
+
+	/**
+	 * Split the timestamps map into one horizontal tile per thread. Every tile
+	 * owns a range of rows and keeps a copy of the TILE_HALO rows above and
+	 * below it, which are refreshed from their owners before each packet.
+	 */
+	void updateTiles(int32_t numThreads) {
+		const size_t maxTiles    = std::max(static_cast<size_t>(sizeY / (2 * TILE_HALO)), size_t{1});
+		const size_t tilesNumber = std::min(
+			(numThreads <= 0) ? static_cast<size_t>(std::max(cv::getNumThreads(), 1)) : static_cast<size_t>(numThreads),
+			maxTiles);
+
+		if (tiles.size() == tilesNumber) {
+			return;
+		}
+
+		// Gather the current timestamps, to redistribute them to the new tiles.
+		std::vector<uint32_t> timestamps(static_cast<size_t>(sizeX * sizeY), 0);
+
+		for (const auto &tile : tiles) {
+			std::copy(tile.map.cbegin() + ((tile.rowStart - tile.haloStart) * sizeX),
+				tile.map.cbegin() + ((tile.rowEnd - tile.haloStart) * sizeX),
+				timestamps.begin() + (tile.rowStart * sizeX));
+		}
+
+		tiles.clear();
+		tiles.resize(tilesNumber);
+
+		for (size_t i = 0; i < tilesNumber; i++) {
+			auto &tile = tiles[i];
+
+			tile.rowStart  = static_cast<int16_t>((static_cast<size_t>(sizeY) * i) / tilesNumber);
+			tile.rowEnd    = static_cast<int16_t>((static_cast<size_t>(sizeY) * (i + 1)) / tilesNumber);
+			tile.haloStart = static_cast<int16_t>(std::max(tile.rowStart - TILE_HALO, 0));
+			tile.haloEnd   = static_cast<int16_t>(std::min(tile.rowEnd + TILE_HALO, static_cast<int>(sizeY)));
+
+			tile.map.assign(timestamps.cbegin() + (tile.haloStart * sizeX), timestamps.cbegin() + (tile.haloEnd * sizeX));
+
+			std::fill(rowTiles.begin() + tile.rowStart, rowTiles.begin() + tile.rowEnd, static_cast<uint16_t>(i));
+		}
+	}
+
+	/**
+	 * Copy the rows bordering every tile from the tiles owning them.
+	 */
+	void exchangeTileHalos() {
+		if (tiles.size() == 1) {
+			return;
+		}
+
+		for (auto &tile : tiles) {
+			for (int16_t y = tile.haloStart; y < tile.haloEnd; y++) {
+				if ((y >= tile.rowStart) && (y < tile.rowEnd)) {
+					continue;
+				}
+
+				const auto &owner = tiles[rowTiles[static_cast<size_t>(y)]];
+
+				std::copy_n(owner.map.cbegin() + ((y - owner.haloStart) * sizeX), sizeX,
+					tile.map.begin() + ((y - tile.haloStart) * sizeX));
+			}
+		}
+	}
+
+	inline size_t doBackgroundActivityLookup(const TimestampTile &tile, int16_t x, int16_t y, size_t pixelIndex,
+		int64_t timestamp, bool polarity, size_t *supportIndexes, int32_t backgroundActivityTime,
+		bool backgroundActivityCheckPolarity) const {
+		const uint32_t *timestampsMap = tile.map.data();
+
 		// Compute map limits.
 		bool notBorderLeft  = (x != 0);
 		bool notBorderDown  = (y != (sizeY - 1));
@@ -443,12 +778,73 @@ public:
 		std::sort(hotPixelArray.begin(), hotPixelArray.end(),
 			[](const pixel_with_count &a, const pixel_with_count &b) { return (a.count > b.count); });
 
+		hotPixelGenerateMap();
+	}
+
+	void hotPixelGenerateMap() {
+		std::fill(hotPixelMap.begin(), hotPixelMap.end(), 0);
+
+		for (const auto &px : hotPixelArray) {
+			hotPixelMap[static_cast<size_t>((px.y * sizeX) + px.x)] = 1;
+		}
+
 		// Print list of hot pixels for debugging.
 		for (size_t i = 0; i < hotPixelArray.size(); i++) {
 			log.debug.format("HotPixel %zu: X=%" PRIi16 ", Y=%" PRIi16 ", count=%" PRIi32 ".", i, hotPixelArray[i].x,
 				hotPixelArray[i].y, hotPixelArray[i].count);
 		}
 	}
+
+	/**
+	 * Load the hot pixels from the configured file, one "X Y COUNT" line per
+	 * pixel. Pixels outside of the current resolution are ignored.
+	 */
+	void hotPixelLoadFile() {
+		const std::string fileName = config.get<dvCfgType::STRING>("hotPixelFile");
+		if (fileName.empty()) {
+			return;
+		}
+
+		std::ifstream file(fileName);
+		if (!file) {
+			log.info << "HotPixel file '" << fileName << "' not found, no hot pixels loaded." << dv::logEnd;
+			return;
+		}
+
+		hotPixelArray.clear();
+
+		pixel_with_count elem;
+		while (file >> elem.x >> elem.y >> elem.count) {
+			if ((elem.x >= 0) && (elem.x < sizeX) && (elem.y >= 0) && (elem.y < sizeY)) {
+				hotPixelArray.push_back(elem);
+			}
+		}
+
+		hotPixelGenerateMap();
+
+		log.info << "HotPixel file '" << fileName << "': loaded " << hotPixelArray.size() << " hot pixels."
+				 << dv::logEnd;
+	}
+
+	/**
+	 * Save the current hot pixels to the configured file, if any.
+	 */
+	void hotPixelSaveFile() {
+		const std::string fileName = config.get<dvCfgType::STRING>("hotPixelFile");
+		if (fileName.empty()) {
+			return;
+		}
+
+		std::ofstream file(fileName, std::ios::trunc);
+
+		for (const auto &px : hotPixelArray) {
+			file << px.x << " " << px.y << " " << px.count << "\n";
+		}
+
+		if (!file) {
+			log.error << "HotPixel file '" << fileName << "': failed to save hot pixels." << dv::logEnd;
+		}
+	}
 };
 
 registerModuleClass(DVSNoiseFilter)
@@ -10,6 +10,9 @@ using dvCfgType  = dvCfg::AttributeType;
 using dvCfgFlags = dvCfg::AttributeFlags;
 
 class FrameStatistics : public dv::ModuleBase {
+private:
+	dv::ConfigHandle<dvCfgType::INT> numBins;
+
 public:
 	static void addInputs(dv::InputDefinitionList &in) {
 		in.addFrameInput("frames");
@@ -32,16 +35,18 @@ public:
 		// Populate frame output info node. Must have generated statistics histogram frame
 		// maximum size. Max size is 256 x 128 due to max number of bins being 256.
 		outputs.getFrameOutput("histogram").setup(256, 128, inputs.getFrameInput("frames").getOriginDescription());
+
+		numBins = config.handle<dvCfgType::INT>("numBins");
 	}
 
 	void run() override {
 		auto frame_in = inputs.getFrameInput("frames").frame();
 		auto hist_out = outputs.getFrameOutput("histograms").frame();
 
-		auto numBins = config.get<dvCfgType::INT>("numBins");
+		int32_t bins = numBins.get();
 
-		hist_out->sizeX     = static_cast<int16_t>(numBins);
-		hist_out->sizeY     = static_cast<int16_t>(numBins / 2);
+		hist_out->sizeX     = static_cast<int16_t>(bins);
+		hist_out->sizeY     = static_cast<int16_t>(bins / 2);
 		hist_out->format    = dv::FrameFormat::GRAY;
 		hist_out->timestamp = frame_in->timestamp; // Only set main timestamp.
 		hist_out->pixels.resize(
@@ -52,7 +57,7 @@ public:
 		const float *histRange = {range};
 
 		cv::Mat hist;
-		cv::calcHist(frame_in.getMatPointer().get(), 1, nullptr, cv::Mat(), hist, 1, &numBins, &histRange, true, false);
+		cv::calcHist(frame_in.getMatPointer().get(), 1, nullptr, cv::Mat(), hist, 1, &bins, &histRange, true, false);
 
 		// Generate histogram image, with N x N/2 pixels.
 		auto histImage = hist_out.getMat();
@@ -0,0 +1,292 @@
+#ifndef DV_INPUT_HPP
+#define DV_INPUT_HPP
+
+#include "../output/dv_output.hpp"
+
+#include <stdexcept>
+#include <string>
+
+/// Largest message accepted, protects against allocating for garbage.
+#define DV_INPUT_MAX_MESSAGE_SIZE (256 * 1024 * 1024)
+
+/// Attribute of the stream's info node, see DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO.
+struct dvInputStreamAttribute {
+	std::string key;
+	std::string type;
+	std::string description;
+	std::string value;
+};
+
+struct dvInputStatistics {
+	uint64_t packetsNumber;
+	/// Bytes of the messages received, before decompression.
+	uint64_t dataRead;
+	/// Time spent decompressing, in nanoseconds.
+	uint64_t decompressionTime;
+
+	dvInputStatistics() : packetsNumber(0), dataRead(0), decompressionTime(0) {
+	}
+};
+
+/**
+ * Receiving side of dvOutput: turns the messages sent by the network outputs
+ * back into packets, unpacking directly from the received data.
+ */
+class dvInput {
+private:
+	/// Trained dictionaries, by type ID, as used by the server.
+	std::unordered_map<uint32_t, std::vector<uint8_t>> compressionDictionaries;
+	/// Zstd decompression context, reused across packets.
+	dv::unique_ptr_deleter<ZSTD_DCtx> zstdContext;
+	/// Decompressed flatbuffer, reused across packets.
+	std::vector<uint8_t> decompressed;
+	dvInputStatistics statistics;
+
+public:
+	dvInput() : zstdContext(ZSTD_createDCtx(), [](ZSTD_DCtx *ctx) { ZSTD_freeDCtx(ctx); }) {
+		if (!zstdContext) {
+			throw std::bad_alloc();
+		}
+	}
+
+	/**
+	 * Add the dictionary the server uses for packets of the given type.
+	 *
+	 * @param typeIdentifier four character type identifier, such as "EVTS".
+	 * @param dictionary dictionary content.
+	 */
+	void addCompressionDictionary(const char *typeIdentifier, std::vector<uint8_t> dictionary) {
+		compressionDictionaries[dvTypeIdentifierToId(typeIdentifier)] = std::move(dictionary);
+	}
+
+	const dvInputStatistics &getStatistics() const {
+		return (statistics);
+	}
+
+	/**
+	 * Read and validate a compression header.
+	 *
+	 * @param data at least sizeof(dvOutputCompressionHeader) bytes.
+	 *
+	 * @return header in host byte order.
+	 */
+	static dvOutputCompressionHeader parseHeader(const uint8_t *data) {
+		dvOutputCompressionHeader header;
+		std::memcpy(&header, data, sizeof(dvOutputCompressionHeader));
+
+		header.payloadSize      = flatbuffers::EndianScalar(header.payloadSize);
+		header.uncompressedSize = flatbuffers::EndianScalar(header.uncompressedSize);
+		header.typeId           = flatbuffers::EndianScalar(header.typeId);
+
+		if ((header.compression >= DV_OUTPUT_COMPRESSION_COUNT) || (header.payloadSize > DV_INPUT_MAX_MESSAGE_SIZE)
+			|| (header.uncompressedSize > DV_INPUT_MAX_MESSAGE_SIZE)) {
+			throw std::invalid_argument("invalid message header.");
+		}
+
+		return (header);
+	}
+
+	/**
+	 * Header for a message sent without one: a plain size-prefixed
+	 * flatbuffer, as sent without compression, so that it can be unpacked
+	 * the same way.
+	 *
+	 * @param size size of the flatbuffer in bytes, size prefix included.
+	 * @param typeId type of the flatbuffer.
+	 *
+	 * @return header in host byte order.
+	 */
+	static dvOutputCompressionHeader flatbufferHeader(size_t size, uint32_t typeId) {
+		dvOutputCompressionHeader header;
+		header.payloadSize      = static_cast<uint32_t>(size);
+		header.uncompressedSize = static_cast<uint32_t>(size);
+		header.typeId           = typeId;
+		header.compression      = static_cast<uint8_t>(dvOutputCompression::NONE);
+		header.flags            = 0;
+		header.reserved         = 0;
+
+		return (header);
+	}
+
+	/**
+	 * Parse the attributes of a stream description.
+	 *
+	 * @param payload payload of a DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO message.
+	 * @param size size of the payload in bytes.
+	 *
+	 * @return attributes of the stream's info node.
+	 */
+	static std::vector<dvInputStreamAttribute> parseStreamInfo(const uint8_t *payload, size_t size) {
+		std::vector<dvInputStreamAttribute> attributes;
+
+		const char *data = reinterpret_cast<const char *>(payload);
+		const char *end  = data + size;
+
+		const auto next = [&data, end]() {
+			const auto terminator = static_cast<const char *>(std::memchr(data, '\0', static_cast<size_t>(end - data)));
+			if (terminator == nullptr) {
+				throw std::invalid_argument("truncated stream description.");
+			}
+
+			std::string str(data, terminator);
+			data = terminator + 1;
+
+			return (str);
+		};
+
+		while (data < end) {
+			dvInputStreamAttribute attr;
+			attr.key         = next();
+			attr.type        = next();
+			attr.description = next();
+			attr.value       = next();
+
+			attributes.push_back(std::move(attr));
+		}
+
+		return (attributes);
+	}
+
+	/**
+	 * Unpack the payload of one message into a packet. Event packets
+	 * encoded with EVENTS are decoded straight into the packet, all other
+	 * payloads are unpacked from the size-prefixed flatbuffer, after
+	 * decompressing it if needed.
+	 *
+	 * @param header message header, in host byte order.
+	 * @param payload payload of the message, header.payloadSize bytes.
+	 * @param type type of the packet, must match header.typeId.
+	 * @param packet packet to unpack into, of the given type.
+	 */
+	void unpackMessage(
+		const dvOutputCompressionHeader &header, const uint8_t *payload, const dvType &type, void *packet) {
+		if (header.typeId != type.id) {
+			throw std::invalid_argument("packet type differs from the stream type.");
+		}
+
+		const auto compress = static_cast<dvOutputCompression>(header.compression);
+
+		statistics.packetsNumber++;
+		statistics.dataRead += sizeof(dvOutputCompressionHeader) + header.payloadSize;
+
+		if (compress == dvOutputCompression::NONE) {
+			unpackFlatbuffer(payload, header.payloadSize, type, packet);
+			return;
+		}
+
+		const auto decompressionStart = std::chrono::steady_clock::now();
+
+		if (compress == dvOutputCompression::EVENTS) {
+			if (type.id != dvTypeIdentifierToId(dv::EventPacketIdentifier())) {
+				throw std::invalid_argument("encoded events for a type other than events.");
+			}
+
+			// The uncompressed size is bounded by parseHeader(), check the count against it before allocating.
+			const size_t eventCount = dv::EventPacketCodec::decodedEventCount(payload, header.payloadSize);
+
+			if ((eventCount * sizeof(dv::Event)) != header.uncompressedSize) {
+				throw std::invalid_argument("number of encoded events differs from the expected size.");
+			}
+
+			dv::EventPacketCodec::decode(payload, header.payloadSize, static_cast<dv::EventPacketT *>(packet)->events);
+		}
+		else {
+			decompress(compress, header, payload);
+		}
+
+		const auto decompressionTime = std::chrono::steady_clock::now() - decompressionStart;
+
+		statistics.decompressionTime += static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(decompressionTime).count());
+
+		if (compress != dvOutputCompression::EVENTS) {
+			unpackFlatbuffer(decompressed.data(), header.uncompressedSize, type, packet);
+		}
+	}
+
+	/**
+	 * Unpack a size-prefixed flatbuffer in place, without copying it first.
+	 * It comes from the network, so it is verified before being unpacked.
+	 *
+	 * @param data size-prefixed flatbuffer.
+	 * @param size size of data in bytes.
+	 * @param type type of the packet.
+	 * @param packet packet to unpack into, of the given type.
+	 */
+	static void unpackFlatbuffer(const uint8_t *data, size_t size, const dvType &type, void *packet) {
+		if ((size < (2 * sizeof(flatbuffers::uoffset_t)))
+			|| (flatbuffers::GetPrefixedSize(data) != (size - sizeof(flatbuffers::uoffset_t)))) {
+			throw std::invalid_argument("flatbuffer size differs from message size.");
+		}
+
+		if (!flatbuffers::BufferHasIdentifier(data, type.identifier, true)) {
+			throw std::invalid_argument("flatbuffer identifier differs from the stream type.");
+		}
+
+		if ((type.verify == nullptr) || !(*type.verify)(data, size)) {
+			throw std::invalid_argument("flatbuffer verification failed.");
+		}
+
+		(*type.unpack)(packet, flatbuffers::GetSizePrefixedRoot<void>(data));
+	}
+
+private:
+	void decompress(dvOutputCompression compress, const dvOutputCompressionHeader &header, const uint8_t *payload) {
+		const auto dictionary    = compressionDictionaries.find(header.typeId);
+		const bool useDictionary = ((header.flags & DV_OUTPUT_COMPRESSION_FLAG_DICTIONARY) != 0);
+
+		if (useDictionary && (dictionary == compressionDictionaries.cend())) {
+			throw std::invalid_argument("packet compressed with a dictionary that is not available.");
+		}
+
+		decompressed.resize(header.uncompressedSize);
+
+		size_t decompressedSize = 0;
+
+		if (compress == dvOutputCompression::LZ4) {
+			const char *src = reinterpret_cast<const char *>(payload);
+			char *dst       = reinterpret_cast<char *>(decompressed.data());
+			int result;
+
+			if (useDictionary) {
+				result = LZ4_decompress_safe_usingDict(src, dst, static_cast<int>(header.payloadSize),
+					static_cast<int>(decompressed.size()), reinterpret_cast<const char *>(dictionary->second.data()),
+					static_cast<int>(dictionary->second.size()));
+			}
+			else {
+				result = LZ4_decompress_safe(
+					src, dst, static_cast<int>(header.payloadSize), static_cast<int>(decompressed.size()));
+			}
+
+			if (result < 0) {
+				throw std::invalid_argument("LZ4 decompression failed.");
+			}
+
+			decompressedSize = static_cast<size_t>(result);
+		}
+		else if (compress == dvOutputCompression::ZSTD) {
+			size_t result;
+
+			if (useDictionary) {
+				result = ZSTD_decompress_usingDict(zstdContext.get(), decompressed.data(), decompressed.size(), payload,
+					header.payloadSize, dictionary->second.data(), dictionary->second.size());
+			}
+			else {
+				result = ZSTD_decompressDCtx(
+					zstdContext.get(), decompressed.data(), decompressed.size(), payload, header.payloadSize);
+			}
+
+			if (ZSTD_isError(result)) {
+				throw std::invalid_argument(std::string("Zstd decompression failed: ") + ZSTD_getErrorName(result));
+			}
+
+			decompressedSize = result;
+		}
+
+		if (decompressedSize != header.uncompressedSize) {
+			throw std::invalid_argument("decompressed size differs from the expected size.");
+		}
+	}
+};
+
+#endif // DV_INPUT_HPP
@@ -0,0 +1,699 @@
+#ifndef NET_CLIENT_HPP
+#define NET_CLIENT_HPP
+
+#include "dv-sdk/cross/asio_tcptlssocket.hpp"
+#include "dv-sdk/module.hpp"
+
+#include "dv_input.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <chrono>
+#include <deque>
+#include <poll.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+/// Initial size of the receive buffer, grows to fit the largest message.
+#define NET_CLIENT_RECEIVE_BUFFER_SIZE (256 * 1024)
+/// Maximum time run() waits for data, so that the module stays responsive.
+#define NET_CLIENT_POLL_TIMEOUT_MS 100
+/// Maximum time to wait for the connection to be established.
+#define NET_CLIENT_CONNECT_TIMEOUT_MS 1000
+/// Time between attempts to reconnect after losing the connection.
+#define NET_CLIENT_RECONNECT_INTERVAL_MS 1000
+/// File descriptors accepted with one read.
+#define NET_CLIENT_MAX_DESCRIPTORS 8
+
+// Servers only hand off frames as file descriptors where they can pass them.
+#if defined(DV_ASIO_FD_PASSING)
+#	define NET_CLIENT_FD_HANDOFF 1
+#endif
+
+/// Framing of a stream, told apart by its first message.
+enum class NetClientStreamFormat {
+	/// Nothing received yet on this connection.
+	UNKNOWN,
+	/// Compression header before each message, starting with the stream description.
+	HEADER,
+	/// Plain size-prefixed flatbuffers, as sent by servers using None.
+	FLATBUFFER,
+};
+
+/**
+ * AEDAT 4 input from a network output server (client mode), common to all
+ * stream socket protocols. The output type is configured, so that the output
+ * exists before the server can be reached. Servers using the compression
+ * header first send a stream description, which must match that type and
+ * replaces the content of the info node. Servers using None send plain
+ * size-prefixed flatbuffers, the info node then keeps the configured content.
+ * Derived modules add their own configuration and call startClient() from
+ * their constructor.
+ *
+ * Connecting, also after losing the connection, is retried from run()
+ * instead of stopping the module, so that downstream modules keep running.
+ */
+template<typename Protocol> class NetClient : public dv::ModuleBase {
+protected:
+	asio::io_service ioService;
+	typename Protocol::socket socket;
+
+private:
+	dvInput input;
+	typename Protocol::endpoint serverEndpoint;
+	std::chrono::steady_clock::time_point nextConnectAttempt;
+	/// Type of the stream, fixed by the configuration.
+	dvType streamType;
+	/// Known once a connection received its first message.
+	NetClientStreamFormat streamFormat;
+	/// Received data, from bufferStart to bufferEnd, not yet processed.
+	std::vector<uint8_t> buffer;
+	size_t bufferStart;
+	size_t bufferEnd;
+	/// Descriptors received with the data, in order, each for one message.
+	std::deque<int> receivedDescriptors;
+	uint64_t framesHandedOff;
+
+public:
+	/**
+	 * Configuration common to all clients.
+	 */
+	static void addClientConfigOptions(dv::RuntimeConfig &config) {
+		config.add("typeIdentifier",
+			dv::ConfigOption::stringOption("Type identifier of the packets the server sends, such as 'EVTS' or "
+										   "'FRME'. Applied at module start.",
+				"EVTS"));
+		config.add("sizeX",
+			dv::ConfigOption::intOption("Width of the received data, for servers that don't describe the stream "
+										"(compression None). Applied at module start.",
+				346, 1, INT16_MAX));
+		config.add("sizeY",
+			dv::ConfigOption::intOption("Height of the received data, for servers that don't describe the stream "
+										"(compression None). Applied at module start.",
+				260, 1, INT16_MAX));
+		config.add("compressionDictionaries",
+			dv::ConfigOption::directoryOption("Directory with the dictionaries the server uses, one per type, named "
+											  "after the type identifier (e.g. 'EVTS.dict'). Applied on start."));
+
+		config.add("packetsNumber", dv::ConfigOption::statisticOption("Number of packets received."));
+		config.add("dataRead", dv::ConfigOption::statisticOption("Bytes of packets received, before decompression."));
+		config.add("decompressionTime",
+			dv::ConfigOption::statisticOption("Time spent decompressing packets, in microseconds."));
+		config.add("framesHandedOff", dv::ConfigOption::statisticOption("Number of frames received as memory files."));
+	}
+
+	NetClient() :
+		socket(ioService),
+		streamType(dvTypeSystemGetInfoByID(dv::Types::nullId)),
+		streamFormat(NetClientStreamFormat::UNKNOWN),
+		buffer(NET_CLIENT_RECEIVE_BUFFER_SIZE),
+		bufferStart(0),
+		bufferEnd(0),
+		framesHandedOff(0) {
+		loadCompressionDictionaries(config.get<dv::CfgType::STRING>("compressionDictionaries"));
+	}
+
+	~NetClient() override {
+		for (const auto fd : receivedDescriptors) {
+			::close(fd);
+		}
+	}
+
+	void run() override {
+		if (!socket.is_open()) {
+			reconnect();
+			return;
+		}
+
+		// Wait a bit for data, then commit all complete packets. Anything
+		// wrong with the stream drops the connection, to start over clean.
+		try {
+			receive(NET_CLIENT_POLL_TIMEOUT_MS);
+
+			while (const auto message = nextMessage()) {
+				if (streamFormat == NetClientStreamFormat::FLATBUFFER) {
+					commitPacket(dvInput::flatbufferHeader(messageSize(message), streamType.id), message);
+				}
+				else {
+					const auto header  = dvInput::parseHeader(message);
+					const auto payload = message + sizeof(dvOutputCompressionHeader);
+
+					if ((header.flags & DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO) != 0) {
+						if (header.typeId != streamType.id) {
+							throw std::runtime_error("Stream type differs from the configured 'typeIdentifier'.");
+						}
+
+						updateInfoNode(dvInput::parseStreamInfo(payload, header.payloadSize));
+					}
+					else {
+						commitPacket(header, payload);
+					}
+				}
+
+				consumeMessage(message);
+			}
+		}
+		catch (const std::bad_alloc &) {
+			throw;
+		}
+		catch (const std::exception &ex) {
+			log.error.format("Connection to server lost, reconnecting. Error: %s", ex.what());
+
+			disconnect();
+		}
+
+		const auto &stats = input.getStatistics();
+
+		config.set<dv::CfgType::LONG>("packetsNumber", static_cast<int64_t>(stats.packetsNumber));
+		config.set<dv::CfgType::LONG>("dataRead", static_cast<int64_t>(stats.dataRead));
+		config.set<dv::CfgType::LONG>("decompressionTime", static_cast<int64_t>(stats.decompressionTime / 1000));
+		config.set<dv::CfgType::LONG>("framesHandedOff", static_cast<int64_t>(framesHandedOff));
+	}
+
+protected:
+	/**
+	 * Register the output for the configured type and connect to the
+	 * server. A server that can't be reached yet is retried from run(),
+	 * like after losing the connection.
+	 *
+	 * @param endpoint server to connect to, also on reconnects.
+	 */
+	void startClient(const typename Protocol::endpoint &endpoint) {
+		serverEndpoint = endpoint;
+
+		setupOutput(config.get<dv::CfgType::STRING>("typeIdentifier"));
+
+		const auto error = connect();
+		if (error) {
+			log.warning.format(
+				"Failed to connect to server, retrying. Error: %s (%d).", error.message(), error.value());
+
+			nextConnectAttempt
+				= std::chrono::steady_clock::now() + std::chrono::milliseconds(NET_CLIENT_RECONNECT_INTERVAL_MS);
+			return;
+		}
+
+		log.info << "Connected to server." << dv::logEnd;
+	}
+
+private:
+	void commitPacket(const dvOutputCompressionHeader &header, const uint8_t *payload) {
+		// Unpacked straight into the output packet, from the receive buffer or the memory file.
+		auto packet = dvModuleOutputAllocate(moduleData, "output0");
+		if (packet == nullptr) {
+			throw std::bad_alloc();
+		}
+
+		if ((header.flags & DV_OUTPUT_COMPRESSION_FLAG_FILE_DESCRIPTOR) != 0) {
+#if defined(NET_CLIENT_FD_HANDOFF)
+			unpackFileDescriptor(header, packet->obj);
+#else
+			throw std::runtime_error("File descriptors not supported.");
+#endif
+		}
+		else {
+			input.unpackMessage(header, payload, streamType, packet->obj);
+		}
+
+		dvModuleOutputCommit(moduleData, "output0");
+	}
+
+	/**
+	 * Connect to the server, without waiting longer than
+	 * NET_CLIENT_CONNECT_TIMEOUT_MS for an unreachable host.
+	 *
+	 * @return error, if the connection failed.
+	 */
+	boost::system::error_code connect() {
+		boost::system::error_code error;
+
+		socket.open(serverEndpoint.protocol(), error);
+
+		if (!error) {
+			// Reads don't block either way, see receive().
+			socket.non_blocking(true, error);
+		}
+
+		if (!error) {
+			socket.connect(serverEndpoint, error);
+		}
+
+		if (error == asio::error::in_progress) {
+			struct pollfd pfd;
+			pfd.fd      = socket.native_handle();
+			pfd.events  = POLLOUT;
+			pfd.revents = 0;
+
+			const int ready = ::poll(&pfd, 1, NET_CLIENT_CONNECT_TIMEOUT_MS);
+
+			if (ready < 0) {
+				error = boost::system::error_code(errno, boost::system::system_category());
+			}
+			else if (ready == 0) {
+				error = asio::error::timed_out;
+			}
+			else {
+				int connectError    = 0;
+				socklen_t errorSize = sizeof(connectError);
+
+				if (getsockopt(socket.native_handle(), SOL_SOCKET, SO_ERROR, &connectError, &errorSize) < 0) {
+					connectError = errno;
+				}
+
+				error = boost::system::error_code(connectError, boost::system::system_category());
+			}
+		}
+
+		if (error) {
+			boost::system::error_code ignored;
+			socket.close(ignored);
+		}
+		else {
+			streamFormat = NetClientStreamFormat::UNKNOWN;
+		}
+
+		return (error);
+	}
+
+	void disconnect() {
+		boost::system::error_code ignored;
+		socket.close(ignored);
+
+		// Partial messages and their descriptors are lost with the connection.
+		bufferStart = 0;
+		bufferEnd   = 0;
+
+		for (const auto fd : receivedDescriptors) {
+			::close(fd);
+		}
+
+		receivedDescriptors.clear();
+
+		nextConnectAttempt
+			= std::chrono::steady_clock::now() + std::chrono::milliseconds(NET_CLIENT_RECONNECT_INTERVAL_MS);
+	}
+
+	void reconnect() {
+		const auto now = std::chrono::steady_clock::now();
+
+		if (now < nextConnectAttempt) {
+			// Modules without inputs run continuously, don't spin while waiting.
+			std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+				nextConnectAttempt - now, std::chrono::milliseconds(NET_CLIENT_POLL_TIMEOUT_MS)));
+			return;
+		}
+
+		nextConnectAttempt = now + std::chrono::milliseconds(NET_CLIENT_RECONNECT_INTERVAL_MS);
+
+		const auto error = connect();
+		if (error) {
+			log.debug.format("Failed to reconnect to server. Error: %s (%d).", error.message(), error.value());
+			return;
+		}
+
+		// The stream description follows, if the server sends one, see run().
+		log.info << "Connected to server." << dv::logEnd;
+	}
+
+	/**
+	 * Wait for data and read as much as available into the receive buffer,
+	 * along with any file descriptors passed with it.
+	 *
+	 * @param timeout maximum time to wait, in milliseconds.
+	 *
+	 * @return true if data was read.
+	 */
+	bool receive(int timeout) {
+		struct pollfd pfd;
+		pfd.fd      = socket.native_handle();
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+
+		const int ready = ::poll(&pfd, 1, timeout);
+
+		if (ready <= 0) {
+			if ((ready < 0) && (errno != EINTR)) {
+				throw std::runtime_error(std::string("Failed to wait for data: ") + std::strerror(errno));
+			}
+
+			return (false);
+		}
+
+		struct iovec iov;
+		iov.iov_base = buffer.data() + bufferEnd;
+		iov.iov_len  = buffer.size() - bufferEnd;
+
+		struct msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov    = &iov;
+		msg.msg_iovlen = 1;
+
+		int flags = MSG_DONTWAIT;
+
+#if defined(NET_CLIENT_FD_HANDOFF)
+		union {
+			struct cmsghdr align;
+			char data[CMSG_SPACE(NET_CLIENT_MAX_DESCRIPTORS * sizeof(int))];
+		} control;
+
+		msg.msg_control    = control.data;
+		msg.msg_controllen = sizeof(control.data);
+
+#	if defined(MSG_CMSG_CLOEXEC)
+		flags |= MSG_CMSG_CLOEXEC;
+#	endif
+#endif
+
+		const ssize_t received = ::recvmsg(socket.native_handle(), &msg, flags);
+
+		if (received < 0) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+				return (false);
+			}
+
+			throw std::runtime_error(std::string("Failed to read data: ") + std::strerror(errno));
+		}
+
+#if defined(NET_CLIENT_FD_HANDOFF)
+		for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if ((cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS)) {
+				continue;
+			}
+
+			const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+			for (size_t i = 0; i < count; i++) {
+				int fd;
+				std::memcpy(&fd, CMSG_DATA(cmsg) + (i * sizeof(int)), sizeof(int));
+
+				receivedDescriptors.push_back(fd);
+			}
+		}
+
+		if ((msg.msg_flags & MSG_CTRUNC) != 0) {
+			throw std::runtime_error("Too many file descriptors received at once.");
+		}
+#endif
+
+		if (received == 0) {
+			throw std::runtime_error("Server closed the connection.");
+		}
+
+		bufferEnd += static_cast<size_t>(received);
+
+		return (true);
+	}
+
+	/**
+	 * @return the next complete message in the receive buffer, header
+	 * included, or nullptr if more data is needed. The buffer is made big
+	 * enough for the message, so that it can be read in one piece. The
+	 * first message of a connection tells the format of the stream.
+	 */
+	const uint8_t *nextMessage() {
+		const size_t available = bufferEnd - bufferStart;
+		// Also enough for the size prefix, any flatbuffer with a table and identifier is larger.
+		size_t needed = sizeof(dvOutputCompressionHeader);
+
+		if (available >= needed) {
+			const uint8_t *message = buffer.data() + bufferStart;
+
+			if (streamFormat == NetClientStreamFormat::UNKNOWN) {
+				streamFormat = (isStreamInfo(message)) ? (NetClientStreamFormat::HEADER)
+													   : (NetClientStreamFormat::FLATBUFFER);
+			}
+
+			needed = messageSize(message);
+
+			if (available >= needed) {
+				return (message);
+			}
+		}
+
+		if ((buffer.size() - bufferStart) < needed) {
+			// Move the partial message to the front, and grow if it still doesn't fit.
+			std::memmove(buffer.data(), buffer.data() + bufferStart, available);
+			bufferStart = 0;
+			bufferEnd   = available;
+
+			if (buffer.size() < needed) {
+				buffer.resize(needed);
+			}
+		}
+
+		return (nullptr);
+	}
+
+	void consumeMessage(const uint8_t *message) {
+		bufferStart += messageSize(message);
+
+		if (bufferStart == bufferEnd) {
+			bufferStart = 0;
+			bufferEnd   = 0;
+		}
+	}
+
+	/**
+	 * @param message start of a message, at least sizeof(dvOutputCompressionHeader) bytes.
+	 *
+	 * @return size of the whole message in bytes.
+	 */
+	size_t messageSize(const uint8_t *message) const {
+		if (streamFormat == NetClientStreamFormat::FLATBUFFER) {
+			const size_t size
+				= sizeof(flatbuffers::uoffset_t) + flatbuffers::ReadScalar<flatbuffers::uoffset_t>(message);
+
+			if (size > DV_INPUT_MAX_MESSAGE_SIZE) {
+				throw std::invalid_argument("invalid flatbuffer size.");
+			}
+
+			return (size);
+		}
+
+		const auto header = dvInput::parseHeader(message);
+
+		// Passed descriptors replace the payload.
+		if ((header.flags & DV_OUTPUT_COMPRESSION_FLAG_FILE_DESCRIPTOR) != 0) {
+			return (sizeof(dvOutputCompressionHeader));
+		}
+
+		return (sizeof(dvOutputCompressionHeader) + header.payloadSize);
+	}
+
+	/**
+	 * Servers using the compression header first send the stream
+	 * description. A size-prefixed flatbuffer is never mistaken for it:
+	 * where the header has the uncompressed size, equal to the payload
+	 * size, the flatbuffer has its root offset, always smaller than its size.
+	 */
+	static bool isStreamInfo(const uint8_t *message) {
+		dvOutputCompressionHeader header;
+		std::memcpy(&header, message, sizeof(dvOutputCompressionHeader));
+
+		return (((header.flags & DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO) != 0)
+				&& (header.payloadSize == header.uncompressedSize));
+	}
+
+#if defined(NET_CLIENT_FD_HANDOFF)
+	/**
+	 * Unpack a packet from the memory file passed with its message.
+	 */
+	void unpackFileDescriptor(const dvOutputCompressionHeader &header, void *packet) {
+		if (receivedDescriptors.empty()) {
+			throw std::runtime_error("File descriptor missing from message.");
+		}
+
+		const int fd = receivedDescriptors.front();
+		receivedDescriptors.pop_front();
+
+		const dv::unique_ptr_deleter<const int> closer(&fd, [](const int *memoryFile) {
+			::close(*memoryFile);
+		});
+
+		// Mapping beyond the end of the file would fault on access.
+		struct stat fileStat;
+		if ((fstat(fd, &fileStat) < 0) || (static_cast<size_t>(fileStat.st_size) < header.payloadSize)) {
+			throw std::runtime_error("Memory file smaller than the packet.");
+		}
+
+		if (header.payloadSize == 0) {
+			throw std::runtime_error("Empty memory file.");
+		}
+
+		int mapFlags = MAP_SHARED;
+#	if defined(MAP_POPULATE)
+		// Fault in all pages at once, the whole packet is read right away.
+		mapFlags |= MAP_POPULATE;
+#	endif
+
+		void *mapped = mmap(nullptr, header.payloadSize, PROT_READ, mapFlags, fd, 0);
+		if (mapped == MAP_FAILED) {
+			throw std::runtime_error(std::string("Failed to map memory file: ") + std::strerror(errno));
+		}
+
+		const std::shared_ptr<void> unmapper(mapped, [size = header.payloadSize](void *memory) {
+			munmap(memory, size);
+		});
+
+		input.unpackMessage(header, static_cast<const uint8_t *>(mapped), streamType, packet);
+
+		framesHandedOff++;
+	}
+#endif
+
+	/**
+	 * Register the output for the configured type, with the info node
+	 * attributes used until a stream description replaces them.
+	 */
+	void setupOutput(const std::string &typeIdentifier) {
+		if (typeIdentifier.length() != 4) {
+			throw std::invalid_argument("Type identifier must be four characters long.");
+		}
+
+		const auto typeId = dvTypeIdentifierToId(typeIdentifier.c_str());
+		const auto type   = dvTypeSystemGetInfoByID(typeId);
+
+		if ((type.id != typeId) || (type.unpack == nullptr) || (type.verify == nullptr)
+			|| (type.construct == nullptr)) {
+			throw std::invalid_argument("Type '" + typeIdentifier + "' is not supported.");
+		}
+
+		dvModuleRegisterOutput(moduleData, "output0", type.identifier);
+
+		streamType = type;
+
+		std::ostringstream source;
+		source << serverEndpoint;
+
+		const auto intType = dv::Config::Helper::typeToStringConverter(dv::CfgType::INT);
+
+		updateInfoNode({{"sizeX", intType, "Width of the output data. (max x-coordinate + 1)",
+							std::to_string(config.get<dv::CfgType::INT>("sizeX"))},
+			{"sizeY", intType, "Height of the output data. (max y-coordinate + 1)",
+				std::to_string(config.get<dv::CfgType::INT>("sizeY"))},
+			{"source", dv::Config::Helper::typeToStringConverter(dv::CfgType::STRING),
+				"Description of the first origin of the data", source.str()}});
+	}
+
+	/**
+	 * Create the attributes of the output's info node, or update them with
+	 * the description sent on each connection.
+	 */
+	void updateInfoNode(const std::vector<dvInputStreamAttribute> &attributes) {
+		auto infoNode = outputs.infoNode("output0");
+
+		for (const auto &attr : attributes) {
+			const auto attrType = dv::Config::Helper::stringToTypeConverter(attr.type);
+
+			dvConfigAttributeValue value;
+
+			try {
+				// Invalid keys and types would be fatal errors of the configuration tree.
+				if (!isValidKey(attr.key) || (attrType == dv::CfgType::UNKNOWN)) {
+					throw std::invalid_argument("invalid key or type");
+				}
+
+				value = dv::Config::Helper::stringToValueConverter(attrType, attr.value);
+			}
+			catch (const std::exception &) {
+				log.warning.format("Ignoring invalid stream attribute '%s'.", attr.key);
+				continue;
+			}
+
+			const auto currentType = infoNode.getAttributeType(attr.key);
+
+			if (currentType == attrType) {
+				infoNode.updateReadOnlyAttribute(attr.key, attrType, value);
+			}
+			else if (currentType == dv::CfgType::UNKNOWN) {
+				infoNode.createAttribute(attr.key, attrType, value, widestRanges(attrType),
+					dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, attr.description);
+			}
+			else {
+				log.warning.format("Ignoring stream attribute '%s', its type changed.", attr.key);
+			}
+
+			if (attrType == dv::CfgType::STRING) {
+				free(value.string);
+			}
+		}
+	}
+
+	/**
+	 * Same rules as the configuration tree: a letter, then letters, digits
+	 * and '-', '_', '.'.
+	 */
+	static bool isValidKey(const std::string &key) {
+		if (key.empty() || !std::isalpha(static_cast<unsigned char>(key[0]))) {
+			return (false);
+		}
+
+		return (std::all_of(key.cbegin(), key.cend(), [](const char c) {
+			return (std::isalnum(static_cast<unsigned char>(c)) || (c == '-') || (c == '_') || (c == '.'));
+		}));
+	}
+
+	/**
+	 * The server's ranges are not trusted, the values only have to be valid.
+	 */
+	static dvConfigAttributeRanges widestRanges(dv::CfgType type) {
+		dvConfigAttributeRanges ranges;
+
+		switch (type) {
+			case dv::CfgType::INT:
+				ranges.min.intRange = INT32_MIN;
+				ranges.max.intRange = INT32_MAX;
+				break;
+
+			case dv::CfgType::LONG:
+				ranges.min.longRange = INT64_MIN;
+				ranges.max.longRange = INT64_MAX;
+				break;
+
+			case dv::CfgType::FLOAT:
+				ranges.min.floatRange = -FLT_MAX;
+				ranges.max.floatRange = FLT_MAX;
+				break;
+
+			case dv::CfgType::DOUBLE:
+				ranges.min.doubleRange = -DBL_MAX;
+				ranges.max.doubleRange = DBL_MAX;
+				break;
+
+			case dv::CfgType::STRING:
+				ranges.min.stringRange = 0;
+				ranges.max.stringRange = INT32_MAX;
+				break;
+
+			default:
+				ranges.min.intRange = 0;
+				ranges.max.intRange = 0;
+				break;
+		}
+
+		return (ranges);
+	}
+
+	void loadCompressionDictionaries(const std::string &directory) {
+		if (directory.empty()) {
+			return;
+		}
+
+		for (auto &dictionary : dvOutputReadCompressionDictionaries(directory)) {
+			if (dictionary.second.empty()) {
+				log.warning.format("Failed to read compression dictionary for type '%s'.", dictionary.first);
+				continue;
+			}
+
+			input.addCompressionDictionary(dictionary.first.c_str(), std::move(dictionary.second));
+		}
+	}
+};
+
+#endif // NET_CLIENT_HPP
@@ -0,0 +1,33 @@
+#define DV_API_OPENCV_SUPPORT 0
+
+#include "net_client.hpp"
+
+class NetTCPClient : public NetClient<asioTCP> {
+public:
+	static const char *getDescription() {
+		return ("Receive AEDAT 4 data from a TCP output server (client mode), such as one of another runtime.");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add("ipAddress",
+			dv::ConfigOption::stringOption("IPv4 address of the output server to connect to (client mode).",
+				"127.0.0.1"));
+		config.add("portNumber",
+			dv::ConfigOption::intOption(
+				"Port number of the output server to connect to (client mode).", 7777, 1, UINT16_MAX));
+
+		addClientConfigOptions(config);
+	}
+
+	NetTCPClient() {
+		auto endpoint = asioTCP::endpoint(asioIP::address::from_string(config.get<dv::CfgType::STRING>("ipAddress")),
+			static_cast<uint16_t>(config.get<dv::CfgType::INT>("portNumber")));
+
+		log.info.format("Connecting to output server on %s:%d.", config.get<dv::CfgType::STRING>("ipAddress"),
+			config.get<dv::CfgType::INT>("portNumber"));
+
+		startClient(endpoint);
+	}
+};
+
+registerModuleClass(NetTCPClient)
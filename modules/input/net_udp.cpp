@@ -0,0 +1,290 @@
+#define DV_API_OPENCV_SUPPORT 0
+#include "dv-sdk/module.hpp"
+
+#include "../output/dv_output_udp.hpp"
+#include "dv_input.hpp"
+
+#include <array>
+#include <boost/asio.hpp>
+#include <cerrno>
+#include <poll.h>
+
+/// Maximum time run() waits for data, so that the module stays responsive.
+#define NET_UDP_INPUT_POLL_TIMEOUT_MS 100
+/// Datagrams read per run() at most, so that a fast sender can't hold up the module.
+#define NET_UDP_INPUT_MAX_DATAGRAMS 4096
+
+namespace asio   = boost::asio;
+namespace asioIP = asio::ip;
+using asioUDP    = asioIP::udp;
+
+class NetUDPInput : public dv::ModuleBase {
+private:
+	asio::io_service ioService;
+	asioUDP::socket socket;
+	/// Largest possible datagram, so that none is truncated.
+	std::array<uint8_t, UINT16_MAX> datagram;
+	dvOutputUDPReassembler reassembler;
+	dvInput input;
+	/// Type of the stream, fixed by the configuration.
+	dvType streamType;
+	uint64_t packetsInvalid;
+	std::string lastError;
+
+public:
+	static const char *getDescription() {
+		return ("Receive AEDAT 4 data sent via UDP datagrams by a UDP output, unicast or multicast.");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add("ipAddress",
+			dv::ConfigOption::stringOption("IPv4 or IPv6 address to receive on: a local address for unicast, or the "
+										   "group to join for multicast. Applied at module start.",
+				"127.0.0.1"));
+		config.add("portNumber",
+			dv::ConfigOption::intOption("Port number to receive on. Applied at module start.", 7777, 1, UINT16_MAX));
+		config.add("multicastInterface",
+			dv::ConfigOption::stringOption("IPv4 address of the interface to join the multicast group on, empty "
+										   "for the system default. Applied at module start.",
+				""));
+		config.add("receiveBufferSize",
+			dv::ConfigOption::intOption("Size of the socket receive buffer in KiB, larger buffers absorb bursts of "
+										"datagrams. The system may limit it. Applied at module start.",
+				4096, 64, 1048576));
+		config.add("typeIdentifier",
+			dv::ConfigOption::stringOption("Type identifier of the packets sent, such as 'EVTS' or 'FRME'. Datagrams "
+										   "don't describe the stream. Applied at module start.",
+				"EVTS"));
+		config.add("sizeX",
+			dv::ConfigOption::intOption(
+				"Width of the sent data, copied to the output info node. Applied at module start.", 346, 1, INT16_MAX));
+		config.add("sizeY",
+			dv::ConfigOption::intOption(
+				"Height of the sent data, copied to the output info node. Applied at module start.", 260, 1,
+				INT16_MAX));
+
+		config.add("packetsNumber", dv::ConfigOption::statisticOption("Number of packets received."));
+		config.add("dataRead", dv::ConfigOption::statisticOption("Bytes of packets received, before decompression."));
+		config.add("decompressionTime",
+			dv::ConfigOption::statisticOption("Time spent decompressing packets, in microseconds."));
+		config.add("packetsLost",
+			dv::ConfigOption::statisticOption("Number of packets of which at least one datagram was lost."));
+		config.add("packetsInvalid", dv::ConfigOption::statisticOption("Number of packets that failed to unpack."));
+		config.add("datagramsReceived", dv::ConfigOption::statisticOption("Number of datagrams received."));
+		config.add("datagramsLost", dv::ConfigOption::statisticOption("Number of datagrams lost on the way."));
+		config.add("datagramsDiscarded",
+			dv::ConfigOption::statisticOption("Number of datagrams that were malformed, duplicated or late."));
+	}
+
+	NetUDPInput() :
+		socket(ioService),
+		reassembler(DV_INPUT_MAX_MESSAGE_SIZE),
+		streamType(dvTypeSystemGetInfoByID(dv::Types::nullId)),
+		packetsInvalid(0) {
+		setupOutput(config.get<dv::CfgType::STRING>("typeIdentifier"));
+
+		// Configure socket.
+		const auto address = asioIP::address::from_string(config.get<dv::CfgType::STRING>("ipAddress"));
+		const auto port    = static_cast<uint16_t>(config.get<dv::CfgType::INT>("portNumber"));
+
+		if (address.is_multicast()) {
+			// Bound to the group's port on all addresses, the group filters what is received.
+			const auto any = (address.is_v6()) ? (asioIP::address(asioIP::address_v6::any()))
+											   : (asioIP::address(asioIP::address_v4::any()));
+
+			socket.open(address.is_v6() ? asioUDP::v6() : asioUDP::v4());
+			socket.set_option(asioUDP::socket::reuse_address(true));
+			socket.bind(asioUDP::endpoint(any, port));
+
+			const auto multicastInterface = config.get<dv::CfgType::STRING>("multicastInterface");
+
+			if (!multicastInterface.empty() && address.is_v4()) {
+				socket.set_option(asioIP::multicast::join_group(
+					address.to_v4(), asioIP::address_v4::from_string(multicastInterface)));
+			}
+			else {
+				socket.set_option(asioIP::multicast::join_group(address));
+			}
+		}
+		else {
+			socket.open(address.is_v6() ? asioUDP::v6() : asioUDP::v4());
+			socket.bind(asioUDP::endpoint(address, port));
+		}
+
+		socket.set_option(
+			asio::socket_base::receive_buffer_size(config.get<dv::CfgType::INT>("receiveBufferSize") * 1024));
+
+		// Reads don't block, see receive().
+		socket.non_blocking(true);
+
+		log.info.format("Input ready, receiving on %s:%d (%s).", config.get<dv::CfgType::STRING>("ipAddress"),
+			config.get<dv::CfgType::INT>("portNumber"), (address.is_multicast()) ? ("multicast") : ("unicast"));
+	}
+
+	void run() override {
+		receive(NET_UDP_INPUT_POLL_TIMEOUT_MS);
+
+		const auto &inputStats = input.getStatistics();
+		const auto &udpStats   = reassembler.getStatistics();
+
+		config.set<dv::CfgType::LONG>("packetsNumber", static_cast<int64_t>(inputStats.packetsNumber));
+		config.set<dv::CfgType::LONG>("dataRead", static_cast<int64_t>(inputStats.dataRead));
+		config.set<dv::CfgType::LONG>(
+			"decompressionTime", static_cast<int64_t>(inputStats.decompressionTime / 1000));
+		config.set<dv::CfgType::LONG>("packetsLost", static_cast<int64_t>(udpStats.messagesLost));
+		config.set<dv::CfgType::LONG>("packetsInvalid", static_cast<int64_t>(packetsInvalid));
+		config.set<dv::CfgType::LONG>("datagramsReceived", static_cast<int64_t>(udpStats.datagramsReceived));
+		config.set<dv::CfgType::LONG>("datagramsLost", static_cast<int64_t>(udpStats.datagramsLost));
+		config.set<dv::CfgType::LONG>("datagramsDiscarded", static_cast<int64_t>(udpStats.datagramsDiscarded));
+	}
+
+private:
+	/**
+	 * Register the output for the configured type, with the info node
+	 * attributes the datagrams can't carry.
+	 */
+	void setupOutput(const std::string &typeIdentifier) {
+		if (typeIdentifier.length() != 4) {
+			throw std::invalid_argument("Type identifier must be four characters long.");
+		}
+
+		const auto typeId = dvTypeIdentifierToId(typeIdentifier.c_str());
+		const auto type   = dvTypeSystemGetInfoByID(typeId);
+
+		if ((type.id != typeId) || (type.unpack == nullptr) || (type.verify == nullptr)
+			|| (type.construct == nullptr)) {
+			throw std::invalid_argument("Type '" + typeIdentifier + "' is not supported.");
+		}
+
+		dvModuleRegisterOutput(moduleData, "output0", type.identifier);
+
+		auto infoNode = outputs.infoNode("output0");
+
+		const auto sizeX = config.get<dv::CfgType::INT>("sizeX");
+		const auto sizeY = config.get<dv::CfgType::INT>("sizeY");
+
+		infoNode.create<dv::CfgType::INT>("sizeX", sizeX, {sizeX, sizeX},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Width of the output data. (max x-coordinate + 1)");
+		infoNode.create<dv::CfgType::INT>("sizeY", sizeY, {sizeY, sizeY},
+			dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Height of the output data. (max y-coordinate + 1)");
+		infoNode.create<dv::CfgType::STRING>("source", "UDP " + config.get<dv::CfgType::STRING>("ipAddress"),
+			{0, 8192}, dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT,
+			"Description of the first origin of the data");
+
+		streamType = type;
+	}
+
+	/**
+	 * Wait for datagrams, then read all available ones and commit the
+	 * packets they complete.
+	 *
+	 * @param timeout maximum time to wait, in milliseconds.
+	 */
+	void receive(int timeout) {
+		struct pollfd pfd;
+		pfd.fd      = socket.native_handle();
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+
+		const int ready = ::poll(&pfd, 1, timeout);
+
+		if (ready <= 0) {
+			if ((ready < 0) && (errno != EINTR)) {
+				log.error.format("Failed to wait for data: %s", std::strerror(errno));
+			}
+
+			return;
+		}
+
+		for (size_t i = 0; i < NET_UDP_INPUT_MAX_DATAGRAMS; i++) {
+			boost::system::error_code error;
+			const size_t received = socket.receive(asio::buffer(datagram), 0, error);
+
+			if (error == asio::error::would_block) {
+				return;
+			}
+
+			if (error) {
+				// Only log when the error changes, it usually repeats for every datagram.
+				if (error.message() != lastError) {
+					log.error.format("Failed to receive datagram. Error: %s (%d).", error.message(), error.value());
+				}
+
+				lastError = error.message();
+				return;
+			}
+
+			if (reassembler.addDatagram(datagram.data(), received)) {
+				commitPacket(reassembler.getMessage());
+			}
+		}
+	}
+
+	void commitPacket(const std::vector<uint8_t> &message) {
+		try {
+			dvOutputCompressionHeader header;
+			const uint8_t *payload;
+
+			if (hasCompressionHeader(message)) {
+				if (message.size() < sizeof(dvOutputCompressionHeader)) {
+					throw std::invalid_argument("message too short.");
+				}
+
+				header  = dvInput::parseHeader(message.data());
+				payload = message.data() + sizeof(dvOutputCompressionHeader);
+
+				// Only the dictionary flag applies to messages received over UDP.
+				if ((header.payloadSize != (message.size() - sizeof(dvOutputCompressionHeader)))
+					|| ((header.flags & ~DV_OUTPUT_COMPRESSION_FLAG_DICTIONARY) != 0)) {
+					throw std::invalid_argument("invalid message header.");
+				}
+			}
+			else {
+				// Sent without compression, the message is the flatbuffer itself.
+				header  = dvInput::flatbufferHeader(message.size(), streamType.id);
+				payload = message.data();
+			}
+
+			// Unpacked straight into the output packet, from the reassembled message.
+			auto packet = dvModuleOutputAllocate(moduleData, "output0");
+			if (packet == nullptr) {
+				throw std::bad_alloc();
+			}
+
+			input.unpackMessage(header, payload, streamType, packet->obj);
+
+			dvModuleOutputCommit(moduleData, "output0");
+
+			lastError.clear();
+		}
+		catch (const std::bad_alloc &) {
+			throw;
+		}
+		catch (const std::exception &ex) {
+			// Datagrams can come from anywhere, one bad packet doesn't end the stream.
+			packetsInvalid++;
+
+			if (ex.what() != lastError) {
+				log.warning.format("Dropping invalid packet. Error: %s", ex.what());
+			}
+
+			lastError = ex.what();
+		}
+	}
+
+	/**
+	 * Messages sent with compression start with a header, others are a
+	 * size-prefixed flatbuffer. The first four bytes are the size of what
+	 * follows in both cases, which tells them apart as the header is larger.
+	 */
+	static bool hasCompressionHeader(const std::vector<uint8_t> &message) {
+		if (message.size() < sizeof(flatbuffers::uoffset_t)) {
+			return (true);
+		}
+
+		return (flatbuffers::ReadScalar<flatbuffers::uoffset_t>(message.data())
+				!= (message.size() - sizeof(flatbuffers::uoffset_t)));
+	}
+};
+
+registerModuleClass(NetUDPInput)
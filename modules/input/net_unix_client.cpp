@@ -0,0 +1,29 @@
+#define DV_API_OPENCV_SUPPORT 0
+
+#include "net_client.hpp"
+
+class NetUnixClient : public NetClient<asioLocal> {
+public:
+	static const char *getDescription() {
+		return ("Receive AEDAT 4 data from a Unix domain socket output server (client mode). Large frames passed as "
+				"file descriptors are unpacked without copying them through the socket.");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add("socketPath",
+			dv::ConfigOption::stringOption("Path of the Unix domain socket to connect to (client mode).",
+				"/tmp/dv.sock"));
+
+		addClientConfigOptions(config);
+	}
+
+	NetUnixClient() {
+		const auto socketPath = config.get<dv::CfgType::STRING>("socketPath");
+
+		log.info.format("Connecting to output server on '%s'.", socketPath);
+
+		startClient(asioLocal::endpoint(socketPath));
+	}
+};
+
+registerModuleClass(NetUnixClient)
@@ -27,6 +27,11 @@ private:
 	size_t lastFoundPoints;
 	bool calibrationCompleted;
 
+	// Configuration, read on every frame.
+	dv::ConfigHandle<dv::CfgType::INT> captureInterval;
+	dv::ConfigHandle<dv::CfgType::INT> minNumberOfPoints;
+	dv::ConfigHandle<dv::CfgType::BOOL> useFisheyeModel;
+
 public:
 	static void addInputs(dv::InputDefinitionList &in) {
 		in.addFrameInput("frames", false);
@@ -70,6 +75,11 @@ public:
 	LensCalibration() {
 		imageSize = inputs.getFrameInput("frames").size();
 		outputs.getFrameOutput("patternCorners").setup(inputs.getFrameInput("frames"));
+
+		captureInterval   = config.handle<dv::CfgType::INT>("captureInterval");
+		minNumberOfPoints = config.handle<dv::CfgType::INT>("minNumberOfPoints");
+		useFisheyeModel   = config.handle<dv::CfgType::BOOL>("useFisheyeModel");
+
 		configUpdate();
 	}
 
@@ -131,7 +141,7 @@ public:
 			int64_t currTimestamp = frame_in->timestamp;
 
 			// If enough time has passed, try to add a new point set.
-			if ((currTimestamp - lastFrameTimestamp) >= config.get<dv::CfgType::INT>("captureInterval")) {
+			if ((currTimestamp - lastFrameTimestamp) >= captureInterval.get()) {
 				lastFrameTimestamp = currTimestamp;
 
 				bool foundPoint = findNewPoints(frame_in, corners_out);
@@ -141,8 +151,7 @@ public:
 			// If enough points have been found in this round, try doing calibration.
 			size_t foundPoints = imagePoints.size();
 
-			if (foundPoints >= static_cast<size_t>(config.get<dv::CfgType::INT>("minNumberOfPoints"))
-				&& foundPoints > lastFoundPoints) {
+			if (foundPoints >= static_cast<size_t>(minNumberOfPoints.get()) && foundPoints > lastFoundPoints) {
 				lastFoundPoints = foundPoints;
 
 				double totalAvgError;
@@ -158,7 +167,7 @@ public:
 
 		int chessBoardFlags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
 
-		if (!config.get<dv::CfgType::BOOL>("useFisheyeModel")) {
+		if (!useFisheyeModel.get()) {
 			// Fast check erroneously fails with high distortions like fisheye lens.
 			chessBoardFlags |= cv::CALIB_CB_FAST_CHECK;
 		}
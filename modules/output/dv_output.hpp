@@ -1,66 +1,647 @@
 #ifndef DV_OUTPUT_HPP
 #define DV_OUTPUT_HPP
 
+#include "dv-sdk/data/event_codec.hpp"
 #include "dv-sdk/data/types.hpp"
 #include "dv-sdk/utils.h"
 
+#include <array>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <lz4.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <zstd.h>
+
+/// Compression applied to each output message.
+enum class dvOutputCompression : uint8_t {
+	NONE   = 0,
+	LZ4    = 1,
+	ZSTD   = 2,
+	EVENTS = 3,
+};
+
+/// Number of dvOutputCompression values.
+#define DV_OUTPUT_COMPRESSION_COUNT 4
+
+/// Set of dvOutputCompression values, one bit per value.
+using dvOutputCompressionSet = uint32_t;
+
+static inline dvOutputCompressionSet dvOutputCompressionBit(dvOutputCompression compress) {
+	return (UINT32_C(1) << static_cast<uint8_t>(compress));
+}
+
+/// Names of dvOutputCompression values, as used in the configuration.
+static const char *dvOutputCompressionNames[DV_OUTPUT_COMPRESSION_COUNT] = {"None", "LZ4", "Zstd", "Events"};
+
+/**
+ * @param name name from dvOutputCompressionNames.
+ *
+ * @return the compression with that name, NONE if unknown.
+ */
+static inline dvOutputCompression dvOutputCompressionFromName(const std::string &name) {
+	for (uint8_t c = 0; c < DV_OUTPUT_COMPRESSION_COUNT; c++) {
+		if (name == dvOutputCompressionNames[c]) {
+			return (static_cast<dvOutputCompression>(c));
+		}
+	}
+
+	return (dvOutputCompression::NONE);
+}
+
+/**
+ * @return dvOutputCompressionNames, as choices of a list option.
+ */
+static inline std::vector<std::string> dvOutputCompressionNameList() {
+	return (std::vector<std::string>(std::cbegin(dvOutputCompressionNames), std::cend(dvOutputCompressionNames)));
+}
+
+/// The payload was compressed using the dictionary for its type.
+#define DV_OUTPUT_COMPRESSION_FLAG_DICTIONARY 0x01
+/// The payload does not follow the header, but is the content of a file
+/// descriptor passed along with the header (SCM_RIGHTS, Unix domain sockets
+/// only), starting at offset zero.
+#define DV_OUTPUT_COMPRESSION_FLAG_FILE_DESCRIPTOR 0x02
+/// First message sent to each client, describing the stream: typeId is the
+/// type of all following packets, and the payload holds the attributes of the
+/// stream's info node (sizeX, sizeY, source, ...), each as four NUL-terminated
+/// strings: key, type, description and value. Not compressed.
+#define DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO 0x04
+
+/**
+ * Header prepended to every message when compression is enabled. All fields
+ * are little-endian, like the flatbuffers themselves. The payload following
+ * the header decompresses to the usual size-prefixed flatbuffer. Packets that
+ * do not compress are sent as-is, with compression set to NONE. The flags
+ * mark messages that deviate from this, see DV_OUTPUT_COMPRESSION_FLAG_*.
+ * With EVENTS, event packets are encoded with dv::EventPacketCodec instead,
+ * the payload decodes to the events and the uncompressed size is that of the
+ * events array; other types are sent as-is.
+ */
+struct dvOutputCompressionHeader {
+	/// Size in bytes of the payload following this header.
+	uint32_t payloadSize;
+	/// Size in bytes of the payload after decompression.
+	uint32_t uncompressedSize;
+	/// Type of the contained packet, see dvTypeIdentifierToId().
+	uint32_t typeId;
+	/// One of dvOutputCompression.
+	uint8_t compression;
+	/// DV_OUTPUT_COMPRESSION_FLAG_* bits.
+	uint8_t flags;
+	uint16_t reserved;
+};
+
+static_assert(sizeof(dvOutputCompressionHeader) == 16, "dvOutputCompressionHeader must be 16 bytes");
+
 struct dvOutputStatistics {
 	uint64_t packetsNumber;
+	/// Bytes serialized, before compression.
 	uint64_t packetsSize;
+	/// Bytes of the messages produced, after compression.
 	uint64_t dataWritten;
+	/// Time spent compressing, in nanoseconds.
+	uint64_t compressionTime;
+
+	dvOutputStatistics() : packetsNumber(0), packetsSize(0), dataWritten(0), compressionTime(0) {
+	}
+};
 
-	dvOutputStatistics() : packetsNumber(0), packetsSize(0), dataWritten(0) {
+/**
+ * Pool of FlatBufferBuilders, so that their memory is reused across packets
+ * instead of allocating (and growing) a new builder each time. Builders go
+ * back to the pool when their last reference, usually held by a pending
+ * client write, is released; this may happen on any thread.
+ */
+class dvOutputBuilderPool {
+private:
+	struct Pool {
+		std::mutex lock;
+		std::vector<std::unique_ptr<flatbuffers::FlatBufferBuilder>> builders;
+	};
+
+	/// Maximum number of idle builders kept around.
+	static constexpr size_t MAX_IDLE_BUILDERS = 16;
+	/// Initial size of newly created builders.
+	static constexpr size_t INITIAL_BUILDER_SIZE = 16 * 1024;
+
+	/// Shared with the handed out builders, so they can be released after the pool.
+	std::shared_ptr<Pool> pool;
+
+public:
+	dvOutputBuilderPool() : pool(std::make_shared<Pool>()) {
+	}
+
+	/**
+	 * Get an empty builder, reusing an idle one if available.
+	 *
+	 * @return builder, returned to the pool when the last reference goes away.
+	 */
+	std::shared_ptr<flatbuffers::FlatBufferBuilder> get() {
+		std::unique_ptr<flatbuffers::FlatBufferBuilder> builder;
+
+		{
+			std::scoped_lock lock(pool->lock);
+
+			if (!pool->builders.empty()) {
+				builder = std::move(pool->builders.back());
+				pool->builders.pop_back();
+			}
+		}
+
+		if (builder) {
+			// Keeps the allocated memory.
+			builder->Clear();
+		}
+		else {
+			builder = std::make_unique<flatbuffers::FlatBufferBuilder>(INITIAL_BUILDER_SIZE);
+		}
+
+		return (std::shared_ptr<flatbuffers::FlatBufferBuilder>(
+			builder.release(), [pool = pool](flatbuffers::FlatBufferBuilder *released) {
+				std::unique_ptr<flatbuffers::FlatBufferBuilder> owned(released);
+
+				std::scoped_lock lock(pool->lock);
+
+				if (pool->builders.size() < MAX_IDLE_BUILDERS) {
+					pool->builders.push_back(std::move(owned));
+				}
+			}));
+	}
+};
+
+/**
+ * A serialized packet, ready to be written out: either the size-prefixed
+ * flatbuffer itself, or a compression header followed by the payload.
+ * The message can have a second part (body), sent right after the first
+ * one, that references data in place; the body's owner is kept alive by
+ * the message. Alternatively, the payload can be in a file descriptor
+ * passed along with the message, see DV_OUTPUT_COMPRESSION_FLAG_FILE_DESCRIPTOR.
+ */
+class dvOutputMessage {
+private:
+	std::shared_ptr<const flatbuffers::FlatBufferBuilder> flatbuffer;
+	size_t flatbufferSize;
+	std::vector<uint8_t> compressed;
+	std::shared_ptr<const void> bodyOwner;
+	const uint8_t *body;
+	size_t bodyLength;
+	/// Closes the descriptor once the message is gone.
+	std::shared_ptr<const int> descriptor;
+	size_t descriptorLength;
+
+public:
+	explicit dvOutputMessage(std::shared_ptr<const flatbuffers::FlatBufferBuilder> message) :
+		flatbuffer(std::move(message)),
+		flatbufferSize(flatbuffer->GetSize()),
+		body(nullptr),
+		bodyLength(0),
+		descriptorLength(0) {
+	}
+
+	/**
+	 * Message made of the flatbuffer, except its last bodySize bytes,
+	 * followed by bodySize bytes of data referenced in place.
+	 */
+	dvOutputMessage(std::shared_ptr<const flatbuffers::FlatBufferBuilder> message, std::shared_ptr<const void> owner,
+		const void *bodyData, size_t bodySize) :
+		flatbuffer(std::move(message)),
+		flatbufferSize(flatbuffer->GetSize() - bodySize),
+		bodyOwner(std::move(owner)),
+		body(static_cast<const uint8_t *>(bodyData)),
+		bodyLength(bodySize),
+		descriptorLength(0) {
+	}
+
+	explicit dvOutputMessage(std::vector<uint8_t> message) :
+		flatbufferSize(0),
+		compressed(std::move(message)),
+		body(nullptr),
+		bodyLength(0),
+		descriptorLength(0) {
+	}
+
+	/**
+	 * Message passing a file descriptor, holding descriptorSize bytes of
+	 * data, along with its content.
+	 */
+	dvOutputMessage(std::vector<uint8_t> message, std::shared_ptr<const int> fileDescriptor, size_t descriptorSize) :
+		flatbufferSize(0),
+		compressed(std::move(message)),
+		body(nullptr),
+		bodyLength(0),
+		descriptor(std::move(fileDescriptor)),
+		descriptorLength(descriptorSize) {
+	}
+
+	const uint8_t *data() const {
+		return ((flatbuffer) ? (flatbuffer->GetBufferPointer()) : (compressed.data()));
+	}
+
+	size_t size() const {
+		return ((flatbuffer) ? (flatbufferSize) : (compressed.size()));
+	}
+
+	const uint8_t *bodyData() const {
+		return (body);
+	}
+
+	size_t bodySize() const {
+		return (bodyLength);
+	}
+
+	size_t totalSize() const {
+		return (size() + bodySize());
+	}
+
+	/**
+	 * @return file descriptor to pass along with the message, -1 if none.
+	 */
+	int fileDescriptor() const {
+		return ((descriptor) ? (*descriptor) : (-1));
+	}
+
+	size_t fileDescriptorSize() const {
+		return (descriptorLength);
+	}
+};
+
+/**
+ * The variants of one packet, at most one per compression. Each variant is
+ * encoded once and shared by all clients using that compression.
+ */
+class dvOutputMessageVariants {
+private:
+	std::array<std::shared_ptr<const dvOutputMessage>, DV_OUTPUT_COMPRESSION_COUNT> messages;
+
+public:
+	void set(dvOutputCompression compress, std::shared_ptr<const dvOutputMessage> message) {
+		messages[static_cast<uint8_t>(compress)] = std::move(message);
+	}
+
+	/**
+	 * @return the variant for the given compression, or nullptr if it
+	 * was not requested when the packet was processed.
+	 */
+	const std::shared_ptr<const dvOutputMessage> &get(dvOutputCompression compress) const {
+		return (messages[static_cast<uint8_t>(compress)]);
 	}
 };
 
 class dvOutput {
 private:
-	/// Apply compression.
-	bool compression;
-	/// Compression type flags.
-	uint32_t compressionFlags;
+	/// Compression level, only used by Zstd.
+	int compressionLevel;
+	/// Trained dictionaries, by type ID. Optional.
+	std::unordered_map<uint32_t, std::vector<uint8_t>> compressionDictionaries;
+	/// Zstd dictionaries digested for the current level, by type ID.
+	std::unordered_map<uint32_t, dv::unique_ptr_deleter<ZSTD_CDict>> zstdDictionaries;
+	/// Zstd compression context, reused across packets.
+	dv::unique_ptr_deleter<ZSTD_CCtx> zstdContext;
+	/// LZ4 stream, needed to compress with a dictionary.
+	dv::unique_ptr_deleter<LZ4_stream_t> lz4Stream;
+	/// Reused flatbuffer builders.
+	dvOutputBuilderPool builders;
 	/// Output module statistics collection.
-	struct dvOutputStatistics;
+	dvOutputStatistics statistics;
 
 public:
-	dvOutput() : compression(false), compressionFlags(0) {
+	dvOutput() :
+		compressionLevel(ZSTD_CLEVEL_DEFAULT),
+		zstdContext(ZSTD_createCCtx(), [](ZSTD_CCtx *ctx) { ZSTD_freeCCtx(ctx); }),
+		lz4Stream(LZ4_createStream(), [](LZ4_stream_t *stream) { LZ4_freeStream(stream); }) {
+		if (!zstdContext || !lz4Stream) {
+			throw std::bad_alloc();
+		}
 	}
 
-	void setCompression(bool compress) {
-		compression = compress;
+	void setCompressionLevel(int level) {
+		if (level == compressionLevel) {
+			return;
+		}
+
+		compressionLevel = level;
+
+		// Digested dictionaries depend on the level, rebuild on next use.
+		zstdDictionaries.clear();
 	}
 
-	bool getCompression() {
-		return (compression);
+	int getCompressionLevel() const {
+		return (compressionLevel);
 	}
 
-	void setCompressionFlags(uint32_t compressFlags) {
-		compressionFlags = compressFlags;
+	/**
+	 * Add a trained dictionary (as generated by 'zstd --train') to use when
+	 * compressing packets of the given type. Clients need the same dictionary
+	 * to decompress; LZ4 uses its content as a raw prefix.
+	 *
+	 * @param typeIdentifier four character type identifier, such as "EVTS".
+	 * @param dictionary dictionary content.
+	 */
+	void addCompressionDictionary(const char *typeIdentifier, std::vector<uint8_t> dictionary) {
+		const uint32_t typeId = dvTypeIdentifierToId(typeIdentifier);
+
+		zstdDictionaries.erase(typeId);
+		compressionDictionaries[typeId] = std::move(dictionary);
 	}
 
-	uint32_t getCompressionFlags() {
-		return (compressionFlags);
+	const dvOutputStatistics &getStatistics() const {
+		return (statistics);
 	}
 
-	std::shared_ptr<const flatbuffers::FlatBufferBuilder> processPacket(const dv::Types::TypedObject *packet) {
-		const auto typeInfo = dvTypeSystemGetInfoByID(packet->typeId);
+	/**
+	 * @return compression header with the given content, in wire byte order.
+	 */
+	static dvOutputCompressionHeader makeHeader(size_t payloadSize, size_t uncompressedSize, uint32_t typeId,
+		dvOutputCompression compress, uint8_t flags) {
+		dvOutputCompressionHeader header;
+		header.payloadSize      = flatbuffers::EndianScalar(static_cast<uint32_t>(payloadSize));
+		header.uncompressedSize = flatbuffers::EndianScalar(static_cast<uint32_t>(uncompressedSize));
+		header.typeId           = flatbuffers::EndianScalar(typeId);
+		header.compression      = static_cast<uint8_t>(compress);
+		header.flags            = flags;
+		header.reserved         = 0;
+
+		return (header);
+	}
+
+	/**
+	 * Serialize a packet and encode it with each requested compression.
+	 * The packet is serialized at most once, whatever the number of variants.
+	 *
+	 * @param packet packet to send. Uncompressed event packets reference
+	 * their events in place, the returned message keeps the packet alive.
+	 * @param compressions variants to produce, nothing is done if empty.
+	 *
+	 * @return the messages to write to clients, by compression.
+	 */
+	dvOutputMessageVariants processPacket(
+		std::shared_ptr<const dv::Types::TypedObject> packet, dvOutputCompressionSet compressions) {
+		dvOutputMessageVariants variants;
+
+		if (compressions == 0) {
+			return (variants);
+		}
+
+		const bool isEventPacket = (packet->typeId == dvTypeIdentifierToId(dv::EventPacketIdentifier()));
+
+		// Serialized flatbuffer, shared by all variants that need it.
+		std::shared_ptr<const dvOutputMessage> serialized;
+		size_t packetSize = 0;
+
+		for (uint8_t c = 0; c < DV_OUTPUT_COMPRESSION_COUNT; c++) {
+			const auto compress = static_cast<dvOutputCompression>(c);
+
+			if ((compressions & dvOutputCompressionBit(compress)) == 0) {
+				continue;
+			}
+
+			std::shared_ptr<const dvOutputMessage> message;
+
+			if (isEventPacket && (compress == dvOutputCompression::EVENTS)) {
+				// Encode directly from the events, no need to serialize first.
+				const auto eventPacket = static_cast<const dv::EventPacketT *>(packet->obj);
+
+				message    = encodeEventPacket(packet->typeId, eventPacket);
+				packetSize = eventPacket->events.size() * sizeof(dv::Event);
+			}
+			else if (isEventPacket && (compress == dvOutputCompression::NONE)
+					 && !static_cast<const dv::EventPacketT *>(packet->obj)->events.empty()) {
+				message    = serializeEventPacket(packet, static_cast<const dv::EventPacketT *>(packet->obj)->events);
+				packetSize = message->totalSize();
+			}
+			else {
+				if (!serialized) {
+					serialized = serializePacket(*packet);
+				}
+
+				packetSize = serialized->size();
+
+				if (compress == dvOutputCompression::NONE) {
+					message = serialized;
+				}
+				else {
+					const auto compressionStart = std::chrono::steady_clock::now();
+
+					message = std::make_shared<const dvOutputMessage>(
+						compressPacket(compress, packet->typeId, serialized->data(), serialized->size()));
+
+					const auto compressionTime = std::chrono::steady_clock::now() - compressionStart;
+
+					statistics.compressionTime += static_cast<uint64_t>(
+						std::chrono::duration_cast<std::chrono::nanoseconds>(compressionTime).count());
+				}
+			}
+
+			statistics.dataWritten += message->totalSize();
+
+			variants.set(compress, std::move(message));
+		}
+
+		statistics.packetsNumber++;
+		statistics.packetsSize += packetSize;
+
+		return (variants);
+	}
+
+private:
+	/**
+	 * Serialize an event packet without copying the events: the flatbuffer
+	 * gets an uninitialized events vector, which is always last in the
+	 * buffer, and the events are sent in place after the rest of it.
+	 */
+	std::shared_ptr<const dvOutputMessage> serializeEventPacket(
+		std::shared_ptr<const dv::Types::TypedObject> packet, const dv::cvector<dv::Event> &events) {
+		auto msgBuild = builders.get();
+
+		dv::Event *eventsSlot;
+		const auto eventsOffset = msgBuild->CreateUninitializedVectorOfStructs(events.size(), &eventsSlot);
+
+		msgBuild->FinishSizePrefixed(dv::CreateEventPacket(*msgBuild, eventsOffset), dv::EventPacketIdentifier());
+
+		const size_t eventsSize = events.size() * sizeof(dv::Event);
+
+		return (std::make_shared<const dvOutputMessage>(
+			std::move(msgBuild), std::move(packet), events.data(), eventsSize));
+	}
+
+	std::shared_ptr<const dvOutputMessage> serializePacket(const dv::Types::TypedObject &packet) {
+		const auto typeInfo = dvTypeSystemGetInfoByID(packet.typeId);
 
 		// Construct serialized flatbuffer packet.
-		auto msgBuild = std::make_shared<flatbuffers::FlatBufferBuilder>(16 * 1024);
+		auto msgBuild = builders.get();
 
-		auto offset = (*typeInfo.pack)(msgBuild.get(), packet->obj);
+		auto offset = (*typeInfo.pack)(msgBuild.get(), packet.obj);
 
 		msgBuild->FinishSizePrefixed(flatbuffers::Offset<void>(offset), typeInfo.identifier);
 
-		uint8_t *data   = msgBuild->GetBufferPointer();
-		size_t dataSize = msgBuild->GetSize();
+		return (std::make_shared<const dvOutputMessage>(std::move(msgBuild)));
+	}
+
+	std::shared_ptr<const dvOutputMessage> encodeEventPacket(uint32_t typeId, const dv::EventPacketT *packet) {
+		const auto &events    = packet->events;
+		const size_t dataSize = events.size() * sizeof(dv::Event);
+
+		const auto compressionStart = std::chrono::steady_clock::now();
+
+		std::vector<uint8_t> message(
+			sizeof(dvOutputCompressionHeader) + dv::EventPacketCodec::encodedSizeBound(events.size()));
+
+		const size_t payloadSize = dv::EventPacketCodec::encode(
+			events.data(), events.size(), message.data() + sizeof(dvOutputCompressionHeader));
+
+		writeHeader(message, payloadSize, dataSize, typeId, dvOutputCompression::EVENTS, 0);
+
+		const auto compressionTime = std::chrono::steady_clock::now() - compressionStart;
 
-		if (compression) {
-			// TODO: compression.
+		statistics.compressionTime += static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(compressionTime).count());
+
+		return (std::make_shared<const dvOutputMessage>(std::move(message)));
+	}
+
+	/**
+	 * Compress one serialized packet and prepend the compression header.
+	 * Falls back to sending the packet as-is if it does not get smaller.
+	 *
+	 * @param compress compression to apply.
+	 * @param typeId type of the packet, selects the dictionary.
+	 * @param data size-prefixed flatbuffer.
+	 * @param dataSize size of data in bytes.
+	 *
+	 * @return the full message: header followed by the payload.
+	 */
+	std::vector<uint8_t> compressPacket(
+		dvOutputCompression compress, uint32_t typeId, const uint8_t *data, size_t dataSize) {
+		const auto dictionary    = compressionDictionaries.find(typeId);
+		const bool useDictionary = (dictionary != compressionDictionaries.cend());
+
+		std::vector<uint8_t> message;
+		size_t payloadSize = 0;
+
+		if (compress == dvOutputCompression::LZ4) {
+			const int bound = LZ4_compressBound(static_cast<int>(dataSize));
+			message.resize(sizeof(dvOutputCompressionHeader) + static_cast<size_t>(bound));
+
+			const char *src = reinterpret_cast<const char *>(data);
+			char *dst       = reinterpret_cast<char *>(message.data() + sizeof(dvOutputCompressionHeader));
+			int result;
+
+			if (useDictionary) {
+				// Loading also resets the stream, so each packet stays independent.
+				LZ4_loadDict(lz4Stream.get(), reinterpret_cast<const char *>(dictionary->second.data()),
+					static_cast<int>(dictionary->second.size()));
+
+				result = LZ4_compress_fast_continue(lz4Stream.get(), src, dst, static_cast<int>(dataSize), bound, 1);
+			}
+			else {
+				result = LZ4_compress_default(src, dst, static_cast<int>(dataSize), bound);
+			}
+
+			payloadSize = (result > 0) ? (static_cast<size_t>(result)) : (0);
 		}
+		else if (compress == dvOutputCompression::ZSTD) {
+			const size_t bound = ZSTD_compressBound(dataSize);
+			message.resize(sizeof(dvOutputCompressionHeader) + bound);
+
+			uint8_t *dst = message.data() + sizeof(dvOutputCompressionHeader);
+			size_t result;
 
-		return (msgBuild);
+			if (useDictionary) {
+				result = ZSTD_compress_usingCDict(
+					zstdContext.get(), dst, bound, data, dataSize, getZstdDictionary(typeId, dictionary->second));
+			}
+			else {
+				result = ZSTD_compressCCtx(zstdContext.get(), dst, bound, data, dataSize, compressionLevel);
+			}
+
+			payloadSize = (ZSTD_isError(result)) ? (0) : (result);
+		}
+
+		if ((payloadSize == 0) || (payloadSize >= dataSize)) {
+			// Incompressible, compression failed or not applicable: send the packet as-is.
+			message.resize(sizeof(dvOutputCompressionHeader) + dataSize);
+			std::memcpy(message.data() + sizeof(dvOutputCompressionHeader), data, dataSize);
+
+			writeHeader(message, dataSize, dataSize, typeId, dvOutputCompression::NONE, 0);
+		}
+		else {
+			writeHeader(message, payloadSize, dataSize, typeId, compress,
+				(useDictionary) ? (DV_OUTPUT_COMPRESSION_FLAG_DICTIONARY) : (0));
+		}
+
+		return (message);
+	}
+
+	/**
+	 * Fill in the compression header at the start of the message and trim
+	 * the message to the header plus payload.
+	 */
+	static void writeHeader(std::vector<uint8_t> &message, size_t payloadSize, size_t uncompressedSize,
+		uint32_t typeId, dvOutputCompression compress, uint8_t flags) {
+		const auto header = makeHeader(payloadSize, uncompressedSize, typeId, compress, flags);
+
+		std::memcpy(message.data(), &header, sizeof(dvOutputCompressionHeader));
+		message.resize(sizeof(dvOutputCompressionHeader) + payloadSize);
+	}
+
+	const ZSTD_CDict *getZstdDictionary(uint32_t typeId, const std::vector<uint8_t> &dictionary) {
+		auto digested = zstdDictionaries.find(typeId);
+
+		if (digested == zstdDictionaries.end()) {
+			dv::unique_ptr_deleter<ZSTD_CDict> cdict(
+				ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel),
+				[](ZSTD_CDict *dict) { ZSTD_freeCDict(dict); });
+
+			if (!cdict) {
+				throw std::bad_alloc();
+			}
+
+			digested = zstdDictionaries.emplace(typeId, std::move(cdict)).first;
+		}
+
+		return (digested->second.get());
 	}
 };
 
+/**
+ * Read the compression dictionaries in a directory, the 'XXXX.dict' files,
+ * where XXXX is the type identifier. Shared by outputs and inputs, which
+ * must use the same dictionaries.
+ *
+ * @param directory directory to scan.
+ *
+ * @return type identifier and content of each dictionary, the content is
+ * empty if the file couldn't be read.
+ */
+static inline std::vector<std::pair<std::string, std::vector<uint8_t>>> dvOutputReadCompressionDictionaries(
+	const std::string &directory) {
+	if (!boost::filesystem::is_directory(directory)) {
+		throw std::invalid_argument("Compression dictionaries directory '" + directory + "' does not exist.");
+	}
+
+	std::vector<std::pair<std::string, std::vector<uint8_t>>> dictionaries;
+
+	for (const auto &entry : boost::filesystem::directory_iterator(directory)) {
+		const auto &path = entry.path();
+
+		if ((path.extension() != ".dict") || (path.stem().string().length() != 4)) {
+			continue;
+		}
+
+		std::ifstream file(path.string(), std::ios::binary);
+		std::vector<uint8_t> dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		dictionaries.emplace_back(path.stem().string(), std::move(dictionary));
+	}
+
+	return (dictionaries);
+}
+
 #endif // DV_OUTPUT_HPP
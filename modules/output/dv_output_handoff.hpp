@@ -0,0 +1,143 @@
+#ifndef DV_OUTPUT_HANDOFF_HPP
+#define DV_OUTPUT_HANDOFF_HPP
+
+#include "dv-sdk/module.h"
+
+#include <atomic>
+#include <libcaercpp/ringbuffer.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Lock-free handoff of messages from the module thread to an I/O thread,
+ * common to the network outputs. Messages reference the input packet they
+ * were made from, as event data is sent in place. Inputs can only be
+ * dismissed from the module thread, so the I/O thread hands packets back
+ * once done with them, see dismissSentPackets().
+ */
+template<typename Message> class dvOutputHandoff {
+private:
+	dvModuleData moduleData;
+	std::string inputName;
+	/// Thread sending the messages, started by the module after this.
+	const std::thread &ioThread;
+
+	libcaer::ringbuffer::RingBuffer<Message *> messageQueue;
+	std::atomic_bool messagesPending;
+
+	// Packets the I/O thread is done with, dismissed by the module thread.
+	std::mutex sentPacketsLock;
+	std::vector<const dv::Types::TypedObject *> sentPackets;
+
+public:
+	dvOutputHandoff(dvModuleData data, std::string input, const std::thread &sendThread, size_t queueSize) :
+		moduleData(data),
+		inputName(std::move(input)),
+		ioThread(sendThread),
+		messageQueue(queueSize),
+		messagesPending(false) {
+	}
+
+	/**
+	 * The I/O thread must have exited, so that all packets can be
+	 * dismissed right away.
+	 */
+	~dvOutputHandoff() {
+		// Free messages the I/O thread didn't get to.
+		while (!messageQueue.empty()) {
+			delete messageQueue.get();
+		}
+
+		dismissSentPackets();
+	}
+
+	dvOutputHandoff(const dvOutputHandoff &)            = delete;
+	dvOutputHandoff &operator=(const dvOutputHandoff &) = delete;
+
+	/**
+	 * Take ownership of an input packet, on the module thread. It is
+	 * dismissed once no message references it anymore.
+	 */
+	std::shared_ptr<const dv::Types::TypedObject> wrapPacket(const dv::Types::TypedObject *packet) {
+		const auto dismiss = [this](const dv::Types::TypedObject *obj) {
+			if (std::this_thread::get_id() == ioThread.get_id()) {
+				std::scoped_lock lock(sentPacketsLock);
+				sentPackets.push_back(obj);
+			}
+			else {
+				dvModuleInputDismiss(moduleData, inputName.c_str(), obj);
+			}
+		};
+
+		return (std::shared_ptr<const dv::Types::TypedObject>{packet, dismiss});
+	}
+
+	/**
+	 * Queue a message for the I/O thread, on the module thread.
+	 *
+	 * @param message message to queue, dropped if the queue is full.
+	 * @param wakeUp called to wake up the I/O thread, unless it still has
+	 * to look at the queue anyway.
+	 *
+	 * @return false if the queue was full, the I/O thread can't keep up.
+	 */
+	template<typename WakeUp> bool put(std::unique_ptr<Message> message, WakeUp wakeUp) {
+		bool queued = true;
+
+		try {
+			messageQueue.put(message.get());
+			message.release();
+		}
+		catch (const std::out_of_range &) {
+			queued = false;
+		}
+
+		if (!messagesPending.exchange(true)) {
+			wakeUp();
+		}
+
+		return (queued);
+	}
+
+	/**
+	 * Called by the I/O thread once woken up, before looking at the queue,
+	 * so that messages put from then on wake it up again.
+	 */
+	void woken() {
+		messagesPending = false;
+	}
+
+	/**
+	 * Next queued message, on the I/O thread.
+	 *
+	 * @return message, or nullptr if the queue is empty.
+	 */
+	std::unique_ptr<Message> get() {
+		if (messageQueue.empty()) {
+			return (nullptr);
+		}
+
+		return (std::unique_ptr<Message>{messageQueue.get()});
+	}
+
+	/**
+	 * Dismiss the packets the I/O thread is done with, on the module thread.
+	 */
+	void dismissSentPackets() {
+		std::vector<const dv::Types::TypedObject *> packets;
+
+		{
+			std::scoped_lock lock(sentPacketsLock);
+			std::swap(packets, sentPackets);
+		}
+
+		for (const auto packet : packets) {
+			dvModuleInputDismiss(moduleData, inputName.c_str(), packet);
+		}
+	}
+};
+
+#endif // DV_OUTPUT_HANDOFF_HPP
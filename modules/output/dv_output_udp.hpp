@@ -0,0 +1,199 @@
+#ifndef DV_OUTPUT_UDP_HPP
+#define DV_OUTPUT_UDP_HPP
+
+#include "dv-sdk/data/flatbuffers/flatbuffers.h"
+
+#include <cstring>
+#include <vector>
+
+/// Size of the IP (IPv4 without options) and UDP headers, not part of the payload.
+#define DV_OUTPUT_UDP_IPV4_OVERHEAD (20 + 8)
+#define DV_OUTPUT_UDP_IPV6_OVERHEAD (40 + 8)
+
+/// Maximum number of fragments per message, which bounds the message size.
+#define DV_OUTPUT_UDP_MAX_FRAGMENTS UINT16_MAX
+
+/**
+ * Header prepended to every UDP datagram. Each message (a serialized packet,
+ * the same as sent over TCP) is split into fragments that fit the path MTU,
+ * each sent as one datagram with its own header. All fields are little-endian.
+ */
+struct dvOutputUDPHeader {
+	/// Increases by one with every datagram, gaps mean lost datagrams.
+	/// Starts at zero, also when the sender restarts.
+	uint64_t sequenceNumber;
+	/// Increases by one with every message.
+	uint32_t messageNumber;
+	/// Size in bytes of the whole message.
+	uint32_t messageSize;
+	/// Position in the message of the data following this header.
+	uint32_t fragmentOffset;
+	/// Position of this fragment, from 0 to fragmentCount - 1.
+	uint16_t fragmentIndex;
+	/// Number of fragments the message was split into.
+	uint16_t fragmentCount;
+};
+
+static_assert(sizeof(dvOutputUDPHeader) == 24, "dvOutputUDPHeader must be 24 bytes");
+
+struct dvOutputUDPReceiveStatistics {
+	uint64_t datagramsReceived;
+	/// Datagrams missing from the sequence.
+	uint64_t datagramsLost;
+	/// Datagrams that were malformed, duplicated or arrived too late.
+	uint64_t datagramsDiscarded;
+	uint64_t messagesReceived;
+	/// Messages of which at least one fragment was lost.
+	uint64_t messagesLost;
+
+	dvOutputUDPReceiveStatistics() :
+		datagramsReceived(0),
+		datagramsLost(0),
+		datagramsDiscarded(0),
+		messagesReceived(0),
+		messagesLost(0) {
+	}
+};
+
+/**
+ * Receiving side of the UDP output: puts the fragments of each message back
+ * together and counts losses. Datagrams are expected in order, as sent;
+ * a message is dropped as soon as one of its fragments is missing.
+ */
+class dvOutputUDPReassembler {
+private:
+	bool started;
+	uint64_t nextSequenceNumber;
+	uint32_t lastMessageNumber;
+	/// A message is being put together.
+	bool assembling;
+	uint16_t fragmentsReceived;
+	uint16_t fragmentCount;
+	std::vector<uint8_t> message;
+	/// Larger messages are discarded, the size is not trusted before they complete.
+	size_t maxMessageSize;
+	dvOutputUDPReceiveStatistics statistics;
+
+public:
+	/**
+	 * @param maxSize largest message accepted, datagrams of larger
+	 * messages are discarded instead of allocating for them.
+	 */
+	explicit dvOutputUDPReassembler(size_t maxSize) :
+		started(false),
+		nextSequenceNumber(0),
+		lastMessageNumber(0),
+		assembling(false),
+		fragmentsReceived(0),
+		fragmentCount(0),
+		maxMessageSize(maxSize) {
+	}
+
+	/**
+	 * Add one received datagram, header included.
+	 *
+	 * @param data datagram content.
+	 * @param size size of the datagram in bytes.
+	 *
+	 * @return true if the datagram completed a message, which is then
+	 * available from getMessage() until the next call.
+	 */
+	bool addDatagram(const uint8_t *data, size_t size) {
+		statistics.datagramsReceived++;
+
+		if (size < sizeof(dvOutputUDPHeader)) {
+			statistics.datagramsDiscarded++;
+			return (false);
+		}
+
+		dvOutputUDPHeader header;
+		std::memcpy(&header, data, sizeof(dvOutputUDPHeader));
+
+		const uint64_t sequenceNumber = flatbuffers::EndianScalar(header.sequenceNumber);
+		const uint32_t messageNumber  = flatbuffers::EndianScalar(header.messageNumber);
+		const uint32_t messageSize    = flatbuffers::EndianScalar(header.messageSize);
+		const uint32_t fragmentOffset = flatbuffers::EndianScalar(header.fragmentOffset);
+		const uint16_t fragmentIndex  = flatbuffers::EndianScalar(header.fragmentIndex);
+		const uint16_t fragments      = flatbuffers::EndianScalar(header.fragmentCount);
+		const size_t fragmentSize     = size - sizeof(dvOutputUDPHeader);
+
+		if ((messageSize > maxMessageSize) || (fragmentIndex >= fragments) || (fragmentOffset > messageSize)
+			|| (fragmentSize > (messageSize - fragmentOffset))) {
+			statistics.datagramsDiscarded++;
+			return (false);
+		}
+
+		if (sequenceNumber == 0) {
+			// The sender (re)started, the previous stream is over.
+			if (assembling) {
+				statistics.messagesLost++;
+			}
+
+			started    = false;
+			assembling = false;
+		}
+
+		if (started) {
+			if (sequenceNumber < nextSequenceNumber) {
+				// Duplicated or reordered, its place has already been given up.
+				statistics.datagramsDiscarded++;
+				return (false);
+			}
+
+			statistics.datagramsLost += sequenceNumber - nextSequenceNumber;
+		}
+
+		nextSequenceNumber = sequenceNumber + 1;
+
+		if (!started || (messageNumber != lastMessageNumber)) {
+			if (started) {
+				// Messages of which no fragment arrived at all.
+				statistics.messagesLost += static_cast<uint32_t>(messageNumber - lastMessageNumber - 1);
+			}
+
+			if (assembling) {
+				// The previous message never completed.
+				statistics.messagesLost++;
+			}
+
+			started           = true;
+			lastMessageNumber = messageNumber;
+			assembling        = true;
+			fragmentsReceived = 0;
+			fragmentCount     = fragments;
+
+			message.resize(messageSize);
+		}
+		else if (!assembling || (fragments != fragmentCount) || (messageSize != message.size())) {
+			// Fragment of a message already completed or given up on.
+			statistics.datagramsDiscarded++;
+			return (false);
+		}
+
+		std::memcpy(message.data() + fragmentOffset, data + sizeof(dvOutputUDPHeader), fragmentSize);
+		fragmentsReceived++;
+
+		if (fragmentsReceived < fragmentCount) {
+			return (false);
+		}
+
+		assembling = false;
+		statistics.messagesReceived++;
+
+		return (true);
+	}
+
+	/**
+	 * @return the last completed message: a size-prefixed flatbuffer, or
+	 * a compression header followed by its payload if compression is used.
+	 */
+	const std::vector<uint8_t> &getMessage() const {
+		return (message);
+	}
+
+	const dvOutputUDPReceiveStatistics &getStatistics() const {
+		return (statistics);
+	}
+};
+
+#endif // DV_OUTPUT_UDP_HPP
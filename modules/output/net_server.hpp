@@ -0,0 +1,637 @@
+#ifndef NET_SERVER_HPP
+#define NET_SERVER_HPP
+
+#include "dv-sdk/cross/asio_tcptlssocket.hpp"
+#include "dv-sdk/cross/portable_threads.h"
+#include "dv-sdk/module.hpp"
+
+#include "dv_output.hpp"
+#include "dv_output_handoff.hpp"
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+#define NET_SERVER_MESSAGE_QUEUE_SIZE 256
+
+template<typename Protocol> class NetServer;
+
+/// Per-client settings. The compression only applies to new clients.
+struct ConnectionSettings {
+	dvOutputCompression compression;
+	size_t maxQueueBytes;
+	size_t maxQueuePackets;
+	TCPTLSWriteQueuePolicy queuePolicy;
+	size_t writeBatchBytes;
+	std::chrono::microseconds writeBatchDelay;
+	bool noDelay;
+	bool cork;
+};
+
+template<typename Protocol> class Connection : public std::enable_shared_from_this<Connection<Protocol>> {
+private:
+	NetServer<Protocol> *parent;
+	BasicTLSWriteOrderedSocket<Protocol> socket;
+	std::string name;
+	uint8_t keepAliveReadSpace;
+	dv::Config::Node statisticsNode;
+	// Fixed for the lifetime of the connection, as it determines the framing.
+	dvOutputCompression compression;
+
+public:
+	Connection(typename Protocol::socket s, bool tlsEnabled, asioSSL::context *tlsContext, NetServer<Protocol> *server,
+		std::string clientName, dvOutputCompression compress);
+	~Connection();
+
+	void start();
+	void close();
+	void configure(const ConnectionSettings &settings);
+	dvOutputCompression getCompression() const;
+	void writeMessage(std::shared_ptr<const dvOutputMessage> message, bool keyframe);
+	void updateStatistics();
+
+private:
+	void keepAliveByReading();
+	void handleError(const boost::system::error_code &error, const char *message);
+};
+
+/// Message handed off from the module thread to the I/O thread.
+struct QueuedMessage {
+	dvOutputMessageVariants messages;
+	bool keyframe;
+};
+
+/**
+ * AEDAT 4 output server, common to all stream socket protocols (TCP, Unix
+ * domain sockets). Derived modules add their own configuration and call
+ * startServer() from their constructor, once they know where to listen.
+ */
+template<typename Protocol> class NetServer : public dv::ModuleBase {
+protected:
+	// Network I/O runs on its own thread, so that it continues while no
+	// data arrives. Only the I/O thread accesses the acceptor and clients.
+	asio::io_service ioService;
+	std::unique_ptr<asio::io_service::work> ioWork;
+	std::thread ioThread;
+	asio::steady_timer statisticsTimer;
+	typename Protocol::acceptor acceptor;
+	typename Protocol::socket acceptorNewSocket;
+	asioSSL::context tlsContext;
+	bool tlsEnabled;
+
+	std::vector<Connection<Protocol> *> clients;
+	dvOutput output;
+
+	// Applied to new clients, only accessed on the I/O thread.
+	ConnectionSettings clientSettings;
+	// Compressions used by connected clients, each is encoded once per packet.
+	std::atomic<dvOutputCompressionSet> clientCompressions;
+
+	// Serialized messages for the I/O thread.
+	dvOutputHandoff<QueuedMessage> handoff;
+	uint64_t packetsDropped;
+
+	// Sent first to every client using the compression header.
+	std::shared_ptr<const dvOutputMessage> streamInfo;
+
+public:
+	static void addInputs(dv::InputDefinitionList &in) {
+		in.addInput("output0", "ANYT", false);
+	}
+
+	/**
+	 * Configuration common to all servers.
+	 *
+	 * @param config module configuration to add to.
+	 * @param defaultCompression index of the default in dvOutputCompressionNames.
+	 */
+	static void addServerConfigOptions(dv::RuntimeConfig &config, size_t defaultCompression) {
+		config.add("backlogSize", dv::ConfigOption::intOption("Maximum number of pending connections.", 5, 1, 32));
+		config.add("concurrentConnections",
+			dv::ConfigOption::intOption("Maximum number of concurrent active connections.", 10, 1, 128));
+		config.add("compression",
+			dv::ConfigOption::listOption("Compression applied to each packet: LZ4 is fastest, Zstd compresses better, "
+										 "Events encodes event packets compactly and sends other types as-is. Clients "
+										 "must parse the compression header. Applies to clients connecting afterwards, "
+										 "connected clients keep theirs.",
+				defaultCompression, dvOutputCompressionNameList()));
+		config.add("compressionLevel",
+			dv::ConfigOption::intOption("Zstd compression level, higher compresses better but slower.", 3, 1, 19));
+		config.add("compressionDictionaries",
+			dv::ConfigOption::directoryOption("Directory with trained dictionaries, one per type, named after the type "
+											  "identifier (e.g. 'EVTS.dict'). Applied at module start."));
+
+		config.add("maxQueueSize",
+			dv::ConfigOption::intOption(
+				"Maximum data queued for sending per client, in KiB, 0 for unlimited.", 65536, 0, 4194304));
+		config.add("maxQueuePackets",
+			dv::ConfigOption::intOption(
+				"Maximum packets queued for sending per client, 0 for unlimited.", 1000, 0, 1000000));
+		config.add("queuePolicy",
+			dv::ConfigOption::listOption("What to do when a slow client's queue is full: drop its oldest packets, drop "
+										 "its oldest non-frame packets first, or disconnect it.",
+				0, {"DropOldest", "DropNonKeyframes", "Disconnect"}));
+		config.add("writeBatchSize",
+			dv::ConfigOption::intOption(
+				"Maximum data of queued packets sent with one socket write, in KiB, 0 to write each packet separately.",
+				64, 0, 16384));
+		config.add("writeBatchDelay",
+			dv::ConfigOption::intOption("Maximum time to wait for more packets to fill a write batch, in "
+										"microseconds, 0 to only batch packets that are already queued.",
+				0, 0, 100000));
+
+		config.add("packetsNumber", dv::ConfigOption::statisticOption("Number of packets sent."));
+		config.add("packetsSize", dv::ConfigOption::statisticOption("Bytes of packets sent, before compression."));
+		config.add("dataWritten", dv::ConfigOption::statisticOption("Bytes of packets sent, after compression."));
+		config.add("packetsDropped",
+			dv::ConfigOption::statisticOption("Number of packets dropped because the network thread fell behind."));
+		config.add(
+			"compressionTime", dv::ConfigOption::statisticOption("Time spent compressing packets, in microseconds."));
+	}
+
+	NetServer() :
+		ioWork(std::make_unique<asio::io_service::work>(ioService)),
+		statisticsTimer(ioService),
+		acceptor(ioService),
+		acceptorNewSocket(ioService),
+		tlsContext(asioSSL::context::tlsv12_server),
+		tlsEnabled(false),
+		clientCompressions(0),
+		handoff(moduleData, "output0", ioThread, NET_SERVER_MESSAGE_QUEUE_SIZE),
+		packetsDropped(0) {
+		// Required input is always present.
+		auto inputInfoNode = inputs.infoNode("output0");
+		auto inputNode     = inputInfoNode.getParent();
+
+		auto outputNode     = moduleNode.getRelativeNode("outputs/output0/");
+		auto outputInfoNode = outputNode.getRelativeNode("info/");
+
+		inputNode.copyTo(outputNode);
+		inputInfoNode.copyTo(outputInfoNode);
+
+		streamInfo = makeStreamInfo(inputNode.get<dv::CfgType::STRING>("typeIdentifier"), inputInfoNode);
+
+		// Configure compression.
+		output.setCompressionLevel(config.get<dv::CfgType::INT>("compressionLevel"));
+
+		loadCompressionDictionaries(config.get<dv::CfgType::STRING>("compressionDictionaries"));
+	}
+
+	~NetServer() override {
+		stopServer();
+
+		// Cleanup manually added output info nodes.
+		moduleNode.getRelativeNode("outputs/").removeNode();
+
+		if (moduleNode.existsRelativeNode("clients/")) {
+			moduleNode.getRelativeNode("clients/").removeNode();
+		}
+	}
+
+	void removeClient(Connection<Protocol> *client) {
+		clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+
+		updateClientCompressions();
+	}
+
+	void configUpdate() override {
+		output.setCompressionLevel(config.get<dv::CfgType::INT>("compressionLevel"));
+
+		ioService.post([this, settings = readConnectionSettings()]() {
+			clientSettings = settings;
+
+			for (const auto client : clients) {
+				client->configure(settings);
+			}
+		});
+	}
+
+	void run() override {
+		handoff.dismissSentPackets();
+
+		auto input0 = dvModuleInputGet(moduleData, "output0");
+
+		if (input0 != nullptr) {
+			// Frames are kept over other packets by the DropNonKeyframes policy.
+			const bool keyframe = (input0->typeId == dvTypeIdentifierToId(dv::FrameIdentifier()));
+
+			auto packet = handoff.wrapPacket(input0);
+
+			// Each compression used by clients is encoded once, nothing to do without clients.
+			const auto compressions = clientCompressions.load();
+
+			if (compressions != 0) {
+				auto queued = std::make_unique<QueuedMessage>(
+					QueuedMessage{encodePacket(std::move(packet), compressions), keyframe});
+
+				const bool put = handoff.put(std::move(queued), [this]() {
+					ioService.post([this]() {
+						sendMessages();
+					});
+				});
+
+				if (!put) {
+					// Queue full, the I/O thread can't keep up.
+					packetsDropped++;
+				}
+			}
+
+			const auto &stats = output.getStatistics();
+
+			config.set<dv::CfgType::LONG>("packetsNumber", static_cast<int64_t>(stats.packetsNumber));
+			config.set<dv::CfgType::LONG>("packetsSize", static_cast<int64_t>(stats.packetsSize));
+			config.set<dv::CfgType::LONG>("dataWritten", static_cast<int64_t>(stats.dataWritten));
+			config.set<dv::CfgType::LONG>("packetsDropped", static_cast<int64_t>(packetsDropped));
+			config.set<dv::CfgType::LONG>("compressionTime", static_cast<int64_t>(stats.compressionTime / 1000));
+		}
+	}
+
+protected:
+	/**
+	 * Listen on the given endpoint and start the I/O thread.
+	 *
+	 * @param endpoint where to listen.
+	 *
+	 * @return the endpoint actually listened on, differs for example if
+	 * the TCP port was zero.
+	 */
+	typename Protocol::endpoint startServer(const typename Protocol::endpoint &endpoint) {
+		clientSettings = readConnectionSettings();
+
+		acceptor.open(endpoint.protocol());
+		if constexpr (std::is_same_v<Protocol, asioTCP>) {
+			acceptor.set_option(asioTCP::socket::reuse_address(true));
+		}
+		acceptor.bind(endpoint);
+		acceptor.listen();
+
+		const auto local = acceptor.local_endpoint();
+
+		acceptStart();
+		statisticsTimerStart();
+
+		ioThread = std::thread([this, logger = dv::LoggerGet()]() {
+			// Log as this module.
+			dv::LoggerSet(logger);
+
+			portable_thread_set_name((moduleNode.getName() + "_io").c_str());
+
+			ioService.run();
+		});
+
+		return (local);
+	}
+
+	/**
+	 * Close all connections and wait for the I/O thread to exit. Derived
+	 * modules must call this first on destruction, as the I/O thread calls
+	 * into them.
+	 */
+	void stopServer() {
+		if (!ioThread.joinable()) {
+			return;
+		}
+
+		ioService.post([this]() {
+			acceptor.close();
+			statisticsTimer.cancel();
+
+			// Close all open connections, hard.
+			for (const auto client : clients) {
+				client->close();
+			}
+		});
+
+		// The I/O thread exits once all connections are gone.
+		ioWork.reset();
+		ioThread.join();
+	}
+
+	virtual ConnectionSettings readConnectionSettings() {
+		ConnectionSettings settings;
+
+		settings.compression = dvOutputCompressionFromName(config.get<dv::CfgType::STRING>("compression"));
+
+		settings.maxQueueBytes   = static_cast<size_t>(config.get<dv::CfgType::INT>("maxQueueSize")) * 1024;
+		settings.maxQueuePackets = static_cast<size_t>(config.get<dv::CfgType::INT>("maxQueuePackets"));
+
+		const auto policy = config.get<dv::CfgType::STRING>("queuePolicy");
+
+		if (policy == "DropNonKeyframes") {
+			settings.queuePolicy = TCPTLSWriteQueuePolicy::DROP_NON_KEYFRAME;
+		}
+		else if (policy == "Disconnect") {
+			settings.queuePolicy = TCPTLSWriteQueuePolicy::DISCONNECT;
+		}
+		else {
+			settings.queuePolicy = TCPTLSWriteQueuePolicy::DROP_OLDEST;
+		}
+
+		settings.writeBatchBytes = static_cast<size_t>(config.get<dv::CfgType::INT>("writeBatchSize")) * 1024;
+		settings.writeBatchDelay = std::chrono::microseconds(config.get<dv::CfgType::INT>("writeBatchDelay"));
+
+		settings.noDelay = false;
+		settings.cork    = false;
+
+		return (settings);
+	}
+
+	/**
+	 * @return name of a newly accepted client, for logging and its
+	 * statistics node.
+	 */
+	virtual std::string clientName(const typename Protocol::socket &socket) = 0;
+
+	/**
+	 * Encode a packet with each requested compression, on the module thread.
+	 */
+	virtual dvOutputMessageVariants encodePacket(
+		std::shared_ptr<const dv::Types::TypedObject> packet, dvOutputCompressionSet compressions) {
+		return (output.processPacket(std::move(packet), compressions));
+	}
+
+private:
+	/**
+	 * Describe the stream: its type and the attributes of its info node,
+	 * see DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO.
+	 */
+	static std::shared_ptr<const dvOutputMessage> makeStreamInfo(
+		const std::string &typeIdentifier, const dv::Config::Node infoNode) {
+		std::vector<uint8_t> message(sizeof(dvOutputCompressionHeader));
+
+		const auto append = [&message](const std::string &str) {
+			// Including the terminating NUL character.
+			message.insert(message.end(), str.c_str(), str.c_str() + str.length() + 1);
+		};
+
+		for (const auto &key : infoNode.getAttributeKeys()) {
+			const auto type = infoNode.getAttributeType(key);
+			auto value      = infoNode.getAttribute(key, type);
+
+			append(key);
+			append(dv::Config::Helper::typeToStringConverter(type));
+			append(infoNode.getAttributeDescription(key, type));
+			append(dv::Config::Helper::valueToStringConverter(type, value));
+
+			if (type == dv::CfgType::STRING) {
+				free(value.string);
+			}
+		}
+
+		const size_t payloadSize = message.size() - sizeof(dvOutputCompressionHeader);
+
+		const auto header = dvOutput::makeHeader(payloadSize, payloadSize, dvTypeIdentifierToId(typeIdentifier.c_str()),
+			dvOutputCompression::NONE, DV_OUTPUT_COMPRESSION_FLAG_STREAM_INFO);
+
+		std::memcpy(message.data(), &header, sizeof(dvOutputCompressionHeader));
+
+		return (std::make_shared<const dvOutputMessage>(std::move(message)));
+	}
+
+	void sendMessages() {
+		handoff.woken();
+
+		while (const auto queued = handoff.get()) {
+
+			for (const auto client : clients) {
+				// Clients that connected after the packet was processed have no variant yet.
+				const auto &message = queued->messages.get(client->getCompression());
+
+				if (message) {
+					client->writeMessage(message, queued->keyframe);
+				}
+			}
+		}
+	}
+
+	void statisticsTimerStart() {
+		// Per-client queue statistics, once per second like the module ones.
+#if defined(BOOST_VERSION) && (BOOST_VERSION / 100000) == 1 && (BOOST_VERSION / 100 % 1000) >= 66
+		statisticsTimer.expires_after(std::chrono::seconds(1));
+#else
+		statisticsTimer.expires_from_now(std::chrono::seconds(1));
+#endif
+
+		statisticsTimer.async_wait([this](const boost::system::error_code &error) {
+			// Cancelled on shutdown.
+			if (error) {
+				return;
+			}
+
+			for (const auto client : clients) {
+				client->updateStatistics();
+			}
+
+			statisticsTimerStart();
+		});
+	}
+
+	void updateClientCompressions() {
+		dvOutputCompressionSet compressions = 0;
+
+		for (const auto client : clients) {
+			compressions |= dvOutputCompressionBit(client->getCompression());
+		}
+
+		clientCompressions = compressions;
+	}
+
+	void loadCompressionDictionaries(const std::string &directory) {
+		if (directory.empty()) {
+			return;
+		}
+
+		for (auto &dictionary : dvOutputReadCompressionDictionaries(directory)) {
+			if (dictionary.second.empty()) {
+				log.warning.format("Failed to read compression dictionary for type '%s'.", dictionary.first);
+				continue;
+			}
+
+			log.info.format("Loaded compression dictionary for type '%s' (%d bytes).", dictionary.first,
+				dictionary.second.size());
+
+			output.addCompressionDictionary(dictionary.first.c_str(), std::move(dictionary.second));
+		}
+	}
+
+	void acceptStart() {
+		acceptor.async_accept(
+			acceptorNewSocket,
+			[this](const boost::system::error_code &error) {
+				if (error) {
+					// Ignore cancel error, normal on shutdown.
+					if (error != asio::error::operation_aborted) {
+						log.error.format(
+							"Failed to accept connection. Error: %s (%d).", error.message(), error.value());
+					}
+				}
+				else {
+					auto name = clientName(acceptorNewSocket);
+
+					auto client = std::make_shared<Connection<Protocol>>(std::move(acceptorNewSocket), tlsEnabled,
+						&tlsContext, this, std::move(name), clientSettings.compression);
+
+					clients.push_back(client.get());
+
+					updateClientCompressions();
+
+					client->configure(clientSettings);
+
+					client->start();
+
+					// Clients parsing the compression header learn about the stream first.
+					if (client->getCompression() != dvOutputCompression::NONE) {
+						client->writeMessage(streamInfo, true);
+					}
+
+					acceptStart();
+				}
+			},
+			nullptr);
+	}
+};
+
+/**
+ * Config node holding the statistics of a client, named after it, as node
+ * names can't contain ':' ('address:port' becomes 'address-port').
+ */
+static inline std::string clientNodeName(std::string name) {
+	const auto portSeparator = name.rfind(':');
+
+	if (portSeparator != std::string::npos) {
+		name[portSeparator] = '-';
+	}
+
+	std::replace(name.begin(), name.end(), ':', '.');
+
+	return ("clients/" + name + "/");
+}
+
+template<typename Protocol>
+Connection<Protocol>::Connection(typename Protocol::socket s, bool tlsEnabled, asioSSL::context *tlsContext,
+	NetServer<Protocol> *server, std::string clientName, dvOutputCompression compress) :
+	parent(server),
+	socket(std::move(s), tlsEnabled, tlsContext),
+	name(std::move(clientName)),
+	keepAliveReadSpace(0),
+	statisticsNode(parent->moduleNode.getRelativeNode(clientNodeName(name))),
+	compression(compress) {
+	parent->log.info.format("New connection from client %s.", name);
+
+	statisticsNode.create<dv::CfgType::STRING>("compression",
+		dvOutputCompressionNames[static_cast<uint8_t>(compression)], {0, 16},
+		dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Compression of the packets sent to this client.");
+
+	statisticsNode.create<dv::CfgType::LONG>("queueSize", 0, {0, INT64_MAX},
+		dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Bytes of packets queued for sending.");
+	statisticsNode.create<dv::CfgType::LONG>("queuePackets", 0, {0, INT64_MAX},
+		dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Number of packets queued for sending.");
+	statisticsNode.create<dv::CfgType::LONG>("droppedPackets", 0, {0, INT64_MAX},
+		dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Number of packets dropped due to a full queue.");
+	statisticsNode.create<dv::CfgType::LONG>("droppedSize", 0, {0, INT64_MAX},
+		dv::CfgFlags::READ_ONLY | dv::CfgFlags::NO_EXPORT, "Bytes of packets dropped due to a full queue.");
+}
+
+template<typename Protocol> Connection<Protocol>::~Connection() {
+	parent->removeClient(this);
+
+	statisticsNode.removeNode();
+
+	parent->log.info.format("Closing connection from client %s.", name);
+}
+
+template<typename Protocol> void Connection<Protocol>::start() {
+	auto self(this->shared_from_this());
+
+	socket.start(
+		[this, self](const boost::system::error_code &error) {
+			if (error) {
+				handleError(error, "Failed startup (TLS handshake)");
+			}
+			else {
+				keepAliveByReading();
+			}
+		},
+		asioSSL::stream_base::server);
+}
+
+template<typename Protocol> void Connection<Protocol>::close() {
+	socket.close();
+}
+
+template<typename Protocol> void Connection<Protocol>::configure(const ConnectionSettings &settings) {
+	socket.setWriteQueueLimits(settings.maxQueueBytes, settings.maxQueuePackets, settings.queuePolicy);
+	socket.setWriteBatching(settings.writeBatchBytes, settings.writeBatchDelay, settings.cork);
+
+	if constexpr (std::is_same_v<Protocol, asioTCP>) {
+		socket.setNoDelay(settings.noDelay);
+	}
+}
+
+template<typename Protocol> dvOutputCompression Connection<Protocol>::getCompression() const {
+	return (compression);
+}
+
+template<typename Protocol>
+void Connection<Protocol>::writeMessage(std::shared_ptr<const dvOutputMessage> message, bool keyframe) {
+	auto self(this->shared_from_this());
+
+	std::vector<asio::const_buffer> buffers{asio::buffer(message->data(), message->size())};
+
+	// Data referenced in place follows, queued and dropped together.
+	if (message->bodySize() > 0) {
+		buffers.push_back(asio::buffer(message->bodyData(), message->bodySize()));
+	}
+
+	// The message keeps its file descriptor open until written.
+	const bool queued = socket.write(
+		std::move(buffers), keyframe,
+		[this, self, message](const boost::system::error_code &error, size_t /*length*/) {
+			if (error) {
+				handleError(error, "Failed to write message");
+			}
+		},
+		message->fileDescriptor(), message->fileDescriptorSize());
+
+	if (!queued) {
+		parent->log.warning.format("Client %s: write queue full, disconnecting.", name);
+
+		close();
+	}
+}
+
+template<typename Protocol> void Connection<Protocol>::updateStatistics() {
+	statisticsNode.updateReadOnly<dv::CfgType::LONG>("queueSize", static_cast<int64_t>(socket.getWriteQueueBytes()));
+	statisticsNode.updateReadOnly<dv::CfgType::LONG>(
+		"queuePackets", static_cast<int64_t>(socket.getWriteQueueMessages()));
+	statisticsNode.updateReadOnly<dv::CfgType::LONG>(
+		"droppedPackets", static_cast<int64_t>(socket.getDroppedMessages()));
+	statisticsNode.updateReadOnly<dv::CfgType::LONG>("droppedSize", static_cast<int64_t>(socket.getDroppedBytes()));
+}
+
+template<typename Protocol> void Connection<Protocol>::keepAliveByReading() {
+	auto self(this->shared_from_this());
+
+	socket.read(asio::buffer(&keepAliveReadSpace, sizeof(keepAliveReadSpace)),
+		[this, self](const boost::system::error_code &error, size_t /*length*/) {
+			if (error) {
+				handleError(error, "Read keep-alive failure");
+			}
+			else {
+				handleError(error, "Detected illegal incoming data");
+			}
+		});
+}
+
+template<typename Protocol>
+void Connection<Protocol>::handleError(const boost::system::error_code &error, const char *message) {
+	if (error == asio::error::eof) {
+		// Handle EOF separately.
+		parent->log.info.format("Client %s: connection closed.", name);
+	}
+	else {
+		parent->log.error.format("Client %s: %s. Error: %s (%d).", name, message, error.message(), error.value());
+	}
+}
+
+#endif // NET_SERVER_HPP
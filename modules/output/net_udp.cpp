@@ -0,0 +1,396 @@
+#define DV_API_OPENCV_SUPPORT 0
+#include "dv-sdk/cross/portable_threads.h"
+#include "dv-sdk/module.hpp"
+
+#include "dv_output.hpp"
+#include "dv_output_handoff.hpp"
+#include "dv_output_udp.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <thread>
+
+#define NET_UDP_MESSAGE_QUEUE_SIZE 256
+
+/// How far ahead of the pacing schedule datagrams may be sent, avoids waking up for each one.
+#define NET_UDP_PACING_BURST std::chrono::milliseconds(1)
+
+namespace asio   = boost::asio;
+namespace asioIP = asio::ip;
+using asioUDP    = asioIP::udp;
+
+/// Send settings, only accessed on the I/O thread.
+struct SendSettings {
+	/// Message data per datagram, after the header.
+	size_t fragmentSize;
+	/// Maximum send rate in bits per second, 0 for unlimited.
+	uint64_t pacingRate;
+};
+
+/// Message handed off from the module thread to the I/O thread.
+struct QueuedMessage {
+	std::shared_ptr<const dvOutputMessage> message;
+};
+
+class NetUDP : public dv::ModuleBase {
+private:
+	// Sending runs on its own thread, so that pacing doesn't hold up the
+	// module. Only the I/O thread accesses the socket and send state.
+	asio::io_service ioService;
+	std::unique_ptr<asio::io_service::work> ioWork;
+	std::thread ioThread;
+	asioUDP::socket socket;
+	asioUDP::endpoint destination;
+	// IP and UDP headers added to every datagram.
+	size_t datagramOverhead;
+	asio::steady_timer pacingTimer;
+	bool pacingTimerArmed;
+	std::chrono::steady_clock::time_point nextSendTime;
+	SendSettings sendSettings;
+
+	dvOutput output;
+	// Fixed at module start, receivers must know it to parse messages.
+	dvOutputCompression compression;
+
+	// Message being sent, split into fragments of fragmentSize.
+	std::unique_ptr<QueuedMessage> currentMessage;
+	size_t fragmentSize;
+	uint16_t fragmentIndex;
+	uint16_t fragmentCount;
+	uint32_t messageNumber;
+	uint64_t sequenceNumber;
+	boost::system::error_code lastSendError;
+
+	// Serialized messages for the I/O thread.
+	dvOutputHandoff<QueuedMessage> handoff;
+	std::atomic<uint64_t> packetsDropped;
+	std::atomic<uint64_t> datagramsSent;
+	std::atomic<uint64_t> datagramsDropped;
+
+public:
+	static void addInputs(dv::InputDefinitionList &in) {
+		in.addInput("output0", "ANYT", false);
+	}
+
+	static const char *getDescription() {
+		return ("Send AEDAT 4 data out via UDP datagrams, to one receiver (unicast) or many (multicast).");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add("ipAddress",
+			dv::ConfigOption::stringOption(
+				"IPv4 or IPv6 address to send to, unicast or multicast. Applied at module start.", "127.0.0.1"));
+		config.add("portNumber",
+			dv::ConfigOption::intOption("Port number to send to. Applied at module start.", 7777, 1, UINT16_MAX));
+		config.add("multicastTTL",
+			dv::ConfigOption::intOption("Number of router hops multicast datagrams may cross, 1 keeps them in the "
+										"local network. Applied at module start.",
+				1, 0, 255));
+		config.add("multicastInterface",
+			dv::ConfigOption::stringOption("IPv4 address of the interface to send multicast datagrams on, empty "
+										   "for the system default. Applied at module start.",
+				""));
+		config.add("multicastLoopback",
+			dv::ConfigOption::boolOption(
+				"Also deliver multicast datagrams to receivers on this machine. Applied at module start.", true));
+		config.add("mtu",
+			dv::ConfigOption::intOption("Maximum transmission unit of the network path, in bytes. Packets are split "
+										"into datagrams that fit, including IP and UDP headers, as lost IP "
+										"fragments can't be recovered.",
+				1500, 576, UINT16_MAX));
+		config.add("sendRate",
+			dv::ConfigOption::intOption("Maximum send rate in Mbit/s, 0 for unlimited. Spreads out the datagrams "
+										"of large packets, so that switches and receivers don't drop bursts.",
+				0, 0, 100000));
+		config.add("compression",
+			dv::ConfigOption::listOption("Compression applied to each packet: LZ4 is fastest, Zstd compresses better, "
+										 "Events encodes event packets compactly and sends other types as-is. "
+										 "Receivers must parse the compression header. Applied at module start.",
+				0, dvOutputCompressionNameList()));
+		config.add("compressionLevel",
+			dv::ConfigOption::intOption("Zstd compression level, higher compresses better but slower.", 3, 1, 19));
+
+		config.add("packetsNumber", dv::ConfigOption::statisticOption("Number of packets sent."));
+		config.add("packetsSize", dv::ConfigOption::statisticOption("Bytes of packets sent, before compression."));
+		config.add("dataWritten", dv::ConfigOption::statisticOption("Bytes of packets sent, after compression."));
+		config.add("packetsDropped",
+			dv::ConfigOption::statisticOption(
+				"Number of packets dropped because the network thread fell behind or they were too large."));
+		config.add("datagramsSent", dv::ConfigOption::statisticOption("Number of datagrams sent."));
+		config.add(
+			"datagramsDropped", dv::ConfigOption::statisticOption("Number of datagrams the system failed to send."));
+		config.add(
+			"compressionTime", dv::ConfigOption::statisticOption("Time spent compressing packets, in microseconds."));
+	}
+
+	NetUDP() :
+		ioWork(std::make_unique<asio::io_service::work>(ioService)),
+		socket(ioService),
+		datagramOverhead(0),
+		pacingTimer(ioService),
+		pacingTimerArmed(false),
+		compression(dvOutputCompression::NONE),
+		fragmentSize(0),
+		fragmentIndex(0),
+		fragmentCount(0),
+		messageNumber(0),
+		sequenceNumber(0),
+		handoff(moduleData, "output0", ioThread, NET_UDP_MESSAGE_QUEUE_SIZE),
+		packetsDropped(0),
+		datagramsSent(0),
+		datagramsDropped(0) {
+		// Required input is always present.
+		auto inputInfoNode = inputs.infoNode("output0");
+		auto inputNode     = inputInfoNode.getParent();
+
+		auto outputNode     = moduleNode.getRelativeNode("outputs/output0/");
+		auto outputInfoNode = outputNode.getRelativeNode("info/");
+
+		inputNode.copyTo(outputNode);
+		inputInfoNode.copyTo(outputInfoNode);
+
+		// Configure compression.
+		compression = dvOutputCompressionFromName(config.get<dv::CfgType::STRING>("compression"));
+
+		output.setCompressionLevel(config.get<dv::CfgType::INT>("compressionLevel"));
+
+		// Configure socket.
+		destination = asioUDP::endpoint(asioIP::address::from_string(config.get<dv::CfgType::STRING>("ipAddress")),
+			static_cast<uint16_t>(config.get<dv::CfgType::INT>("portNumber")));
+
+		socket.open(destination.protocol());
+
+		datagramOverhead
+			= (destination.address().is_v6()) ? (DV_OUTPUT_UDP_IPV6_OVERHEAD) : (DV_OUTPUT_UDP_IPV4_OVERHEAD);
+
+		if (destination.address().is_multicast()) {
+			socket.set_option(asioIP::multicast::hops(config.get<dv::CfgType::INT>("multicastTTL")));
+			socket.set_option(asioIP::multicast::enable_loopback(config.get<dv::CfgType::BOOL>("multicastLoopback")));
+
+			const auto multicastInterface = config.get<dv::CfgType::STRING>("multicastInterface");
+
+			if (!multicastInterface.empty() && destination.address().is_v4()) {
+				socket.set_option(
+					asioIP::multicast::outbound_interface(asioIP::address_v4::from_string(multicastInterface)));
+			}
+		}
+
+		sendSettings = readSendSettings();
+
+		log.info.format("Output ready, sending to %s:%d (%s).", config.get<dv::CfgType::STRING>("ipAddress"),
+			config.get<dv::CfgType::INT>("portNumber"),
+			(destination.address().is_multicast()) ? ("multicast") : ("unicast"));
+
+		ioThread = std::thread([this, logger = dv::LoggerGet()]() {
+			// Log as this module.
+			dv::LoggerSet(logger);
+
+			portable_thread_set_name((moduleNode.getName() + "_io").c_str());
+
+			ioService.run();
+		});
+	}
+
+	~NetUDP() override {
+		ioService.post([this]() {
+			pacingTimer.cancel();
+			socket.close();
+		});
+
+		// The I/O thread exits once the pacing wait is cancelled.
+		ioWork.reset();
+		ioThread.join();
+
+		// Queued messages are freed with the handoff.
+		currentMessage.reset();
+
+		// Cleanup manually added output info nodes.
+		moduleNode.getRelativeNode("outputs/").removeNode();
+	}
+
+	void configUpdate() override {
+		output.setCompressionLevel(config.get<dv::CfgType::INT>("compressionLevel"));
+
+		ioService.post([this, settings = readSendSettings()]() {
+			sendSettings = settings;
+		});
+	}
+
+	void run() override {
+		handoff.dismissSentPackets();
+
+		auto input0 = dvModuleInputGet(moduleData, "output0");
+
+		if (input0 != nullptr) {
+			auto variants = output.processPacket(handoff.wrapPacket(input0), dvOutputCompressionBit(compression));
+			auto queued   = std::make_unique<QueuedMessage>(QueuedMessage{variants.get(compression)});
+
+			const bool put = handoff.put(std::move(queued), [this]() {
+				ioService.post([this]() {
+					sendMessages();
+				});
+			});
+
+			if (!put) {
+				// Queue full, the I/O thread can't keep up.
+				packetsDropped++;
+			}
+
+			const auto &stats = output.getStatistics();
+
+			config.set<dv::CfgType::LONG>("packetsNumber", static_cast<int64_t>(stats.packetsNumber));
+			config.set<dv::CfgType::LONG>("packetsSize", static_cast<int64_t>(stats.packetsSize));
+			config.set<dv::CfgType::LONG>("dataWritten", static_cast<int64_t>(stats.dataWritten));
+			config.set<dv::CfgType::LONG>("packetsDropped", static_cast<int64_t>(packetsDropped.load()));
+			config.set<dv::CfgType::LONG>("datagramsSent", static_cast<int64_t>(datagramsSent.load()));
+			config.set<dv::CfgType::LONG>("datagramsDropped", static_cast<int64_t>(datagramsDropped.load()));
+			config.set<dv::CfgType::LONG>("compressionTime", static_cast<int64_t>(stats.compressionTime / 1000));
+		}
+	}
+
+private:
+	SendSettings readSendSettings() {
+		SendSettings settings;
+
+		settings.fragmentSize = static_cast<size_t>(config.get<dv::CfgType::INT>("mtu")) - datagramOverhead
+								- sizeof(dvOutputUDPHeader);
+		settings.pacingRate = static_cast<uint64_t>(config.get<dv::CfgType::INT>("sendRate")) * 1000000;
+
+		return (settings);
+	}
+
+	void sendMessages() {
+		handoff.woken();
+
+		// A pacing wait resumes sending by itself.
+		if (!pacingTimerArmed) {
+			sendDatagrams();
+		}
+	}
+
+	void sendDatagrams() {
+		// Closed on shutdown.
+		if (!socket.is_open()) {
+			return;
+		}
+
+		while (true) {
+			if (!currentMessage) {
+				currentMessage = handoff.get();
+
+				if (!currentMessage) {
+					return;
+				}
+
+				// Kept for the whole message, even if the settings change.
+				const size_t messageSize = currentMessage->message->totalSize();
+
+				fragmentSize  = sendSettings.fragmentSize;
+				fragmentIndex = 0;
+
+				const size_t fragments = std::max<size_t>((messageSize + fragmentSize - 1) / fragmentSize, 1);
+
+				if (fragments > DV_OUTPUT_UDP_MAX_FRAGMENTS) {
+					log.warning.format("Packet of %d bytes is too large to send in %d byte fragments, dropping it.",
+						messageSize, fragmentSize);
+
+					packetsDropped++;
+					currentMessage.reset();
+					continue;
+				}
+
+				fragmentCount = static_cast<uint16_t>(fragments);
+			}
+
+			if (sendSettings.pacingRate > 0) {
+				const auto now = std::chrono::steady_clock::now();
+
+				if (nextSendTime > (now + NET_UDP_PACING_BURST)) {
+					pacingTimerStart();
+					return;
+				}
+
+				// Time the datagram takes on the wire at the configured rate.
+				const size_t offset         = static_cast<size_t>(fragmentIndex) * fragmentSize;
+				const size_t dataSize       = std::min(fragmentSize, currentMessage->message->totalSize() - offset);
+				const uint64_t datagramBits = (dataSize + sizeof(dvOutputUDPHeader) + datagramOverhead) * 8;
+
+				nextSendTime = std::max(nextSendTime, now)
+							   + std::chrono::nanoseconds(datagramBits * 1000000000 / sendSettings.pacingRate);
+			}
+
+			sendFragment();
+
+			if (++fragmentIndex == fragmentCount) {
+				currentMessage.reset();
+				messageNumber++;
+			}
+		}
+	}
+
+	void sendFragment() {
+		const auto &message      = currentMessage->message;
+		const size_t messageSize = message->totalSize();
+		const size_t offset      = static_cast<size_t>(fragmentIndex) * fragmentSize;
+		const size_t end         = std::min(offset + fragmentSize, messageSize);
+
+		dvOutputUDPHeader header;
+		header.sequenceNumber = flatbuffers::EndianScalar(sequenceNumber);
+		header.messageNumber  = flatbuffers::EndianScalar(messageNumber);
+		header.messageSize    = flatbuffers::EndianScalar(static_cast<uint32_t>(messageSize));
+		header.fragmentOffset = flatbuffers::EndianScalar(static_cast<uint32_t>(offset));
+		header.fragmentIndex  = flatbuffers::EndianScalar(fragmentIndex);
+		header.fragmentCount  = flatbuffers::EndianScalar(fragmentCount);
+
+		// A fragment can span the end of the message and the start of its
+		// body, which is referenced in place.
+		const size_t headSize = message->size();
+
+		const std::array<asio::const_buffer, 3> buffers{asio::buffer(&header, sizeof(header)),
+			asio::buffer(message->data() + std::min(offset, headSize),
+				std::min(end, headSize) - std::min(offset, headSize)),
+			asio::buffer(message->bodyData() + (std::max(offset, headSize) - headSize),
+				std::max(end, headSize) - std::max(offset, headSize))};
+
+		boost::system::error_code error;
+		socket.send_to(buffers, destination, 0, error);
+
+		// Also counts failed datagrams, receivers see them as lost.
+		sequenceNumber++;
+
+		if (error) {
+			datagramsDropped++;
+
+			// Only log when the error changes, it usually repeats for every datagram.
+			if (error != lastSendError) {
+				log.error.format("Failed to send datagram. Error: %s (%d).", error.message(), error.value());
+			}
+		}
+		else {
+			datagramsSent++;
+		}
+
+		lastSendError = error;
+	}
+
+	void pacingTimerStart() {
+		pacingTimerArmed = true;
+
+		pacingTimer.expires_at(nextSendTime - NET_UDP_PACING_BURST);
+
+		pacingTimer.async_wait([this](const boost::system::error_code &error) {
+			pacingTimerArmed = false;
+
+			// Cancelled on shutdown.
+			if (error) {
+				return;
+			}
+
+			sendDatagrams();
+		});
+	}
+};
+
+registerModuleClass(NetUDP)
@@ -0,0 +1,201 @@
+#define DV_API_OPENCV_SUPPORT 0
+
+#include "net_server.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(DV_ASIO_FD_PASSING) && defined(MFD_CLOEXEC) && defined(MFD_ALLOW_SEALING)
+#	define NET_UNIX_SERVER_FD_HANDOFF 1
+#endif
+
+class NetUnixServer : public NetServer<asioLocal> {
+private:
+	std::string socketPath;
+	// Only accessed on the I/O thread.
+	uint64_t clientsAccepted;
+	// Frames at least this big are handed off as file descriptors, 0 to disable.
+	size_t handoffSize;
+	uint64_t framesHandedOff;
+
+public:
+	static const char *getDescription() {
+		return ("Send AEDAT 4 data out via a Unix domain socket to local clients (server mode). Large frames can "
+				"be passed as file descriptors instead of being copied through the socket.");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add("socketPath",
+			dv::ConfigOption::stringOption("Path of the Unix domain socket to create (server mode).", "/tmp/dv.sock"));
+
+		// Both the frame handoff and the stream description need the compression header.
+		addServerConfigOptions(config, 3);
+
+		config.add("handoffSize",
+			dv::ConfigOption::intOption(
+				"Frames of at least this size, in KiB, are passed to clients as a sealed memory file instead of "
+				"through the socket, 0 to disable. Can pay off with several clients, as they share the file. Only for "
+				"clients using the compression header (not None).",
+				0, 0, 1048576));
+
+		config.add("framesHandedOff", dv::ConfigOption::statisticOption("Number of frames passed as memory files."));
+	}
+
+	NetUnixServer() :
+		socketPath(config.get<dv::CfgType::STRING>("socketPath")),
+		clientsAccepted(0),
+		handoffSize(static_cast<size_t>(config.get<dv::CfgType::INT>("handoffSize")) * 1024),
+		framesHandedOff(0) {
+		removeStaleSocket();
+
+		startServer(asioLocal::endpoint(socketPath));
+
+		log.info.format("Output server ready on '%s'.", socketPath);
+	}
+
+	~NetUnixServer() override {
+		stopServer();
+
+		::unlink(socketPath.c_str());
+	}
+
+	void configUpdate() override {
+		NetServer::configUpdate();
+
+		handoffSize = static_cast<size_t>(config.get<dv::CfgType::INT>("handoffSize")) * 1024;
+	}
+
+protected:
+	std::string clientName(const asioLocal::socket & /*socket*/) override {
+		// Clients of Unix domain sockets are usually unnamed.
+		return ("client" + std::to_string(++clientsAccepted));
+	}
+
+	dvOutputMessageVariants encodePacket(
+		std::shared_ptr<const dv::Types::TypedObject> packet, dvOutputCompressionSet compressions) override {
+#if defined(NET_UNIX_SERVER_FD_HANDOFF)
+		const auto noneBit             = dvOutputCompressionBit(dvOutputCompression::NONE);
+		const auto handoffCompressions = compressions & ~noneBit;
+
+		if ((handoffSize > 0) && (handoffCompressions != 0)
+			&& (packet->typeId == dvTypeIdentifierToId(dv::FrameIdentifier()))
+			&& (static_cast<const dv::FrameT *>(packet->obj)->pixels.size() >= handoffSize)) {
+			const uint32_t typeId = packet->typeId;
+
+			// Only serialized, into the memory file shared by all clients parsing the header.
+			// Inline None clients get the same serialized buffer, no other variant is encoded.
+			auto variants          = output.processPacket(packet, noneBit);
+			const auto &serialized = variants.get(dvOutputCompression::NONE);
+
+			auto descriptor = writeMemoryFile(serialized->data(), serialized->size());
+
+			if (descriptor) {
+				const auto header = dvOutput::makeHeader(serialized->size(), serialized->size(), typeId,
+					dvOutputCompression::NONE, DV_OUTPUT_COMPRESSION_FLAG_FILE_DESCRIPTOR);
+
+				const auto headerBytes = reinterpret_cast<const uint8_t *>(&header);
+				std::vector<uint8_t> headerMessage(headerBytes, headerBytes + sizeof(header));
+
+				const auto message = std::make_shared<const dvOutputMessage>(
+					std::move(headerMessage), std::move(descriptor), serialized->size());
+
+				for (uint8_t c = 0; c < DV_OUTPUT_COMPRESSION_COUNT; c++) {
+					const auto compress = static_cast<dvOutputCompression>(c);
+
+					if ((handoffCompressions & dvOutputCompressionBit(compress)) != 0) {
+						variants.set(compress, message);
+					}
+				}
+
+				// Only keep the inline variant if some client wants it.
+				if ((compressions & noneBit) == 0) {
+					variants.set(dvOutputCompression::NONE, nullptr);
+				}
+
+				framesHandedOff++;
+				config.set<dv::CfgType::LONG>("framesHandedOff", static_cast<int64_t>(framesHandedOff));
+
+				return (variants);
+			}
+
+			// Don't retry on every frame, until the configuration changes.
+			log.warning.format("Failed to pass frame as memory file, sending through the socket. Error: %s (%d).",
+				std::strerror(errno), errno);
+
+			handoffSize = 0;
+		}
+#endif
+
+		return (NetServer::encodePacket(std::move(packet), compressions));
+	}
+
+private:
+	/**
+	 * A socket file left behind by a runtime that did not exit cleanly would
+	 * make binding fail: remove it, unless a server is still listening on it.
+	 */
+	void removeStaleSocket() {
+		if (boost::filesystem::status(socketPath).type() != boost::filesystem::socket_file) {
+			return;
+		}
+
+		asioLocal::socket probe(ioService);
+		boost::system::error_code error;
+
+		probe.connect(asioLocal::endpoint(socketPath), error);
+
+		if (!error) {
+			throw std::runtime_error("Socket '" + socketPath + "' is in use by another server.");
+		}
+
+		boost::filesystem::remove(socketPath);
+	}
+
+#if defined(NET_UNIX_SERVER_FD_HANDOFF)
+	/**
+	 * Copy data into a new memory file, sealed so that clients can map it
+	 * without it changing or shrinking under them.
+	 *
+	 * @return descriptor of the memory file, closed once the last reference
+	 * is gone, or nullptr on failure.
+	 */
+	static std::shared_ptr<const int> writeMemoryFile(const uint8_t *data, size_t size) {
+		const int fd = memfd_create("dv-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (fd < 0) {
+			return (nullptr);
+		}
+
+		std::shared_ptr<const int> descriptor(new int(fd), [](const int *memoryFile) {
+			::close(*memoryFile);
+			delete memoryFile;
+		});
+
+		while (size > 0) {
+			const ssize_t written = ::write(fd, data, size);
+
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				return (nullptr);
+			}
+
+			data += written;
+			size -= static_cast<size_t>(written);
+		}
+
+#	if defined(F_ADD_SEALS)
+		if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+			return (nullptr);
+		}
+#	endif
+
+		return (descriptor);
+	}
+#endif
+};
+
+registerModuleClass(NetUnixServer)
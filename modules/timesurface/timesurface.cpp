@@ -0,0 +1,234 @@
+#include "dv-sdk/module.hpp"
+#include "dv-sdk/processing.hpp"
+
+#include <cmath>
+
+class TimeSurface : public dv::ModuleBase {
+private:
+	dv::EventStreamSlicer slicer;
+	dv::slicejob_t sliceJob;
+	// In combined mode, all events go to the positive surface.
+	dv::TimeSurface positiveSurface;
+	dv::TimeSurface negativeSurface;
+	// Polarity mode the surfaces were accumulated in.
+	bool surfacesSeparate;
+	dv::time_t lastTime = 0;
+	// Most recent events of the last published interval, for the features.
+	dv::EventStore lastEvents;
+	// Features layout, fixed at module start, as it determines the output size.
+	int featureRadius;
+	int featureCount;
+	int featureGridCols;
+	// Reused output buffers.
+	cv::Mat positiveFrame;
+	cv::Mat negativeFrame;
+	// Configuration, read on every interval.
+	dv::ConfigHandle<dv::CfgType::STRING> polarity;
+	dv::ConfigHandle<dv::CfgType::DOUBLE> tau;
+
+public:
+	static const char *getDescription() {
+		return "Publishes exponentially decaying time surfaces (surfaces of active events) at a fixed rate, and "
+			   "optionally the local time context around the most recent events as features.";
+	}
+
+	static void addInputs(dv::InputDefinitionList &in) {
+		in.addEventInput("events");
+	}
+
+	static void addOutputs(dv::OutputDefinitionList &out) {
+		out.addFrameOutput("frames");
+		out.addFrameOutput("features");
+	}
+
+	static void getConfigOptions(dv::RuntimeConfig &config) {
+		config.add(
+			"publishInterval", dv::ConfigOption::intOption("Time in ms between published time surfaces", 33, 1, 1000));
+		config.add(
+			"tau", dv::ConfigOption::doubleOption("Time constant of the exponential decay in ms", 50.0, 0.01, 10000.0));
+		config.add("polarity",
+			dv::ConfigOption::listOption("Combined: one surface for all events. Separate: positive events in the red, "
+										 "negative events in the blue channel",
+				0, {"Combined", "Separate"}));
+		config.add("featureRadius",
+			dv::ConfigOption::intOption(
+				"Radius in pixels of the local time context published per event on the features output, 0 to disable. "
+				"Applied at module start",
+				0, 0, 10));
+		config.add("featureCount",
+			dv::ConfigOption::intOption(
+				"Maximum number of most recent events per interval to publish features for. Applied at module start", 64,
+				1, 1024));
+	}
+
+	TimeSurface() :
+		positiveSurface(inputs.getEventInput("events").size()),
+		negativeSurface(inputs.getEventInput("events").size()) {
+		outputs.getFrameOutput("frames").setup(inputs.getEventInput("events"));
+
+		polarity = config.handle<dv::CfgType::STRING>("polarity");
+		tau      = config.handle<dv::CfgType::DOUBLE>("tau");
+
+		surfacesSeparate = separatePolarities();
+
+		// The features are laid out in a square grid of (2 * radius + 1) sized cells.
+		featureRadius   = config.getInt("featureRadius");
+		featureCount    = config.getInt("featureCount");
+		featureGridCols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(featureCount))));
+		const int featureGridRows = (featureCount + featureGridCols - 1) / featureGridCols;
+		const int cellSize        = 2 * featureRadius + 1;
+		outputs.getFrameOutput("features")
+			.setup(featureGridCols * cellSize, featureGridRows * cellSize,
+				inputs.getEventInput("events").getOriginDescription());
+
+		sliceJob = slicer.doEveryTimeInterval(config.getInt("publishInterval") * 1000,
+			std::function<void(const dv::EventStore &)>(
+				std::bind(&TimeSurface::doPerInterval, this, std::placeholders::_1)));
+	}
+
+	bool separatePolarities() {
+		return (polarity.get() == "Separate");
+	}
+
+	void doPerInterval(const dv::EventStore &events) {
+		const bool separate = separatePolarities();
+
+		// The surfaces hold different events in each mode, start over clean.
+		if (separate != surfacesSeparate) {
+			positiveSurface  = dv::TimeSurface(inputs.getEventInput("events").size());
+			negativeSurface  = dv::TimeSurface(inputs.getEventInput("events").size());
+			surfacesSeparate = separate;
+		}
+
+		// O(1) per event: only the last timestamp of the pixel is updated.
+		if (separate) {
+			for (const dv::Event &event : events) {
+				if (event.polarity()) {
+					positiveSurface.accumulate(event);
+				}
+				else {
+					negativeSurface.accumulate(event);
+				}
+			}
+		}
+		else {
+			positiveSurface.accumulate(events);
+		}
+
+		if (!events.isEmpty()) {
+			lastTime   = events.getHighestTime();
+			lastEvents = (events.getTotalLength() > static_cast<size_t>(featureCount))
+						   ? events.slice(events.getTotalLength() - static_cast<size_t>(featureCount))
+						   : events;
+		}
+		else {
+			lastEvents = dv::EventStore();
+		}
+
+		if (lastTime == 0) {
+			// Nothing received yet.
+			return;
+		}
+
+		// O(pixels) per publish.
+		const double tauTime = tau.get() * 1000.0;
+		positiveSurface.generateExponentialDecay(lastTime, tauTime, positiveFrame);
+
+		auto frame       = outputs.getFrameOutput("frames").frame();
+		frame->timestamp = lastTime;
+
+		if (separate) {
+			negativeSurface.generateExponentialDecay(lastTime, tauTime, negativeFrame);
+
+			cv::Mat channels[] = {negativeFrame, cv::Mat(negativeFrame.size(), CV_32F, 0.0), positiveFrame};
+			cv::Mat colorFrame;
+			cv::merge(std::vector<cv::Mat>(std::begin(channels), std::end(channels)), colorFrame);
+			frame.commitMat(colorFrame);
+		}
+		else {
+			frame.commitMat(positiveFrame);
+		}
+
+		if (featureRadius > 0 && !lastEvents.isEmpty()) {
+			publishFeatures(separate, tauTime);
+		}
+	}
+
+	/**
+	 * Computes the value of a time surface at the given pixel, relative to
+	 * the time of an event. Pixels updated after the event count as fully active.
+	 */
+	static float contextValue(const dv::TimeSurface &surface, int x, int y, dv::time_t time, double tauTime) {
+		const dv::time_t last = surface.at(static_cast<dv::coord_t>(x), static_cast<dv::coord_t>(y));
+		if (last == 0) {
+			return (0.0f);
+		}
+		if (last >= time) {
+			return (1.0f);
+		}
+		return (static_cast<float>(std::exp(-static_cast<double>(time - last) / tauTime)));
+	}
+
+	/**
+	 * Publishes the local time context (HOTS-style) around the most recent
+	 * events of the last interval, one grid cell per event. The context is
+	 * the time surface around the event, decayed to the event's time.
+	 */
+	void publishFeatures(bool separate, double tauTime) {
+		const int cellSize = 2 * featureRadius + 1;
+		const int channels = separate ? 3 : 1;
+		const int rows     = ((featureCount + featureGridCols - 1) / featureGridCols) * cellSize;
+		const int cols     = featureGridCols * cellSize;
+		const int sizeX    = positiveFrame.cols;
+		const int sizeY    = positiveFrame.rows;
+
+		cv::Mat features(rows, cols, CV_MAKETYPE(CV_32F, channels), 0.0);
+
+		int cell = 0;
+		for (const dv::Event &event : lastEvents) {
+			const int cellX = (cell % featureGridCols) * cellSize;
+			const int cellY = (cell / featureGridCols) * cellSize;
+
+			for (int dy = -featureRadius; dy <= featureRadius; dy++) {
+				const int y = event.y() + dy;
+				if (y < 0 || y >= sizeY) {
+					continue;
+				}
+
+				float *out = features.ptr<float>(cellY + dy + featureRadius);
+
+				for (int dx = -featureRadius; dx <= featureRadius; dx++) {
+					const int x = event.x() + dx;
+					if (x < 0 || x >= sizeX) {
+						continue;
+					}
+
+					const size_t idx = static_cast<size_t>((cellX + dx + featureRadius) * channels);
+					if (separate) {
+						out[idx]     = contextValue(negativeSurface, x, y, event.timestamp(), tauTime);
+						out[idx + 2] = contextValue(positiveSurface, x, y, event.timestamp(), tauTime);
+					}
+					else {
+						out[idx] = contextValue(positiveSurface, x, y, event.timestamp(), tauTime);
+					}
+				}
+			}
+
+			cell++;
+		}
+
+		auto frame       = outputs.getFrameOutput("features").frame();
+		frame->timestamp = lastTime;
+		frame.commitMat(features);
+	}
+
+	void run() override {
+		slicer.addEventPacket(inputs.getEventInput("events").events());
+	}
+
+	void configUpdate() override {
+		slicer.modifyTimeInterval(sliceJob, config.getInt("publishInterval") * 1000);
+	}
+};
+
+registerModuleClass(TimeSurface)
@@ -41,6 +41,8 @@ private:
 	bool windowResize;
 	bool windowMove;
 	int32_t packetSubsampleCount;
+	dv::ConfigHandle<dvCfgType::INT> subsampleRendering;
+	dv::ConfigHandle<dvCfgType::FLOAT> zoomFactor;
 
 public:
 	static void addInputs(dv::InputDefinitionList &in) {
@@ -69,6 +71,9 @@ public:
 		XInitThreads();
 #endif
 
+		subsampleRendering = config.handle<dvCfgType::INT>("subsampleRendering");
+		zoomFactor         = config.handle<dvCfgType::FLOAT>("zoomFactor");
+
 		// Initialize visualizer. Needs size information from the source.
 		auto info = inputs.infoNode("visualize");
 		if (!info) {
@@ -148,7 +153,7 @@ public:
 		// Only render every Nth container (or packet, if using standard visualizer).
 		packetSubsampleCount++;
 
-		if (packetSubsampleCount >= config.get<dvCfgType::INT>("subsampleRendering")) {
+		if (packetSubsampleCount >= subsampleRendering.get()) {
 			packetSubsampleCount = 0;
 		}
 		else {
@@ -174,17 +179,17 @@ public:
 	}
 
 	void updateDisplaySize() {
-		float zoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
-
 		// Update zoom factor.
-		renderer->setZoomFactor(zoomFactor);
+		renderer->setZoomFactor(zoomFactor.get());
 
 		sf::Vector2u newRenderWindowSize(
 			static_cast<unsigned int>(renderSizeX), static_cast<unsigned int>(renderSizeY));
 
 		// Apply zoom to rendered content only, not statistics.
-		newRenderWindowSize.x = static_cast<unsigned int>(static_cast<float>(newRenderWindowSize.x) * zoomFactor);
-		newRenderWindowSize.y = static_cast<unsigned int>(static_cast<float>(newRenderWindowSize.y) * zoomFactor);
+		newRenderWindowSize.x
+			= static_cast<unsigned int>(static_cast<float>(newRenderWindowSize.x) * zoomFactor.get());
+		newRenderWindowSize.y
+			= static_cast<unsigned int>(static_cast<float>(newRenderWindowSize.y) * zoomFactor.get());
 
 		// Set window size to zoomed area (only if value changed!).
 		sf::Vector2u oldSize = renderWindow.getSize();
@@ -236,7 +241,7 @@ public:
 					 || event.type == sf::Event::TextEntered) {
 				// React to key presses, but only if they came from the corresponding display.
 				if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Key::PageUp) {
-					float currentZoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
+					float currentZoomFactor = zoomFactor.get();
 
 					currentZoomFactor += VISUALIZER_ZOOM_INC;
 
@@ -248,7 +253,7 @@ public:
 					config.set<dvCfgType::FLOAT>("zoomFactor", currentZoomFactor);
 				}
 				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Key::PageDown) {
-					float currentZoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
+					float currentZoomFactor = zoomFactor.get();
 
 					currentZoomFactor -= VISUALIZER_ZOOM_INC;
 
@@ -264,7 +269,7 @@ public:
 					config.set<dvCfgType::FLOAT>("zoomFactor", VISUALIZER_ZOOM_DEF);
 				}
 				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Key::W) {
-					int32_t currentSubsampling = config.get<dvCfgType::INT>("subsampleRendering");
+					int32_t currentSubsampling = subsampleRendering.get();
 
 					currentSubsampling--;
 
@@ -276,7 +281,7 @@ public:
 					config.set<dvCfgType::INT>("subsampleRendering", currentSubsampling);
 				}
 				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Key::E) {
-					int32_t currentSubsampling = config.get<dvCfgType::INT>("subsampleRendering");
+					int32_t currentSubsampling = subsampleRendering.get();
 
 					currentSubsampling++;
 
@@ -292,7 +297,7 @@ public:
 					 || event.type == sf::Event::MouseWheelScrolled || event.type == sf::Event::MouseEntered
 					 || event.type == sf::Event::MouseLeft || event.type == sf::Event::MouseMoved) {
 				if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.delta > 0) {
-					float currentZoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
+					float currentZoomFactor = zoomFactor.get();
 
 					currentZoomFactor += (VISUALIZER_ZOOM_INC * static_cast<float>(event.mouseWheelScroll.delta));
 
@@ -304,7 +309,7 @@ public:
 					config.set<dvCfgType::FLOAT>("zoomFactor", currentZoomFactor);
 				}
 				else if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.delta < 0) {
-					float currentZoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
+					float currentZoomFactor = zoomFactor.get();
 
 					// Add because delta is negative for scroll-down.
 					currentZoomFactor += (VISUALIZER_ZOOM_INC * static_cast<float>(event.mouseWheelScroll.delta));
@@ -359,7 +364,7 @@ public:
 
 		// Render content to display.
 		// Render visual area border.
-		float renderZoomFactor = config.get<dvCfgType::FLOAT>("zoomFactor");
+		float renderZoomFactor = zoomFactor.get();
 
 		sfml::Line borderX(sf::Vector2f(0, renderSizeY * renderZoomFactor),
 			sf::Vector2f(renderSizeX * renderZoomFactor, renderSizeY * renderZoomFactor), 2.0f, sf::Color::Blue);
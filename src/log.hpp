@@ -17,9 +17,7 @@ struct LogBlock {
 
 void LoggerInit(void);
 
-// Part of SDK due to dvLog() having to be part of it.
-void LoggerSet(const LogBlock *logger);
-const LogBlock *LoggerGet();
+// LoggerSet() and LoggerGet() are part of the SDK, due to dvLog() having to be part of it.
 
 } // namespace dv
 
@@ -92,6 +92,7 @@ static void mainRunner() {
 	libFuncPtrs->outputGetInfoNode = &dv::Module::outputGetInfoNode;
 	libFuncPtrs->inputGetInfoNode  = &dv::Module::inputGetInfoNode;
 	libFuncPtrs->inputIsConnected  = &dv::Module::inputIsConnected;
+	libFuncPtrs->runTimeoutSet     = &dv::Module::runTimeoutSet;
 
 	dv::SDKLibInit(libFuncPtrs);
 
@@ -29,6 +29,7 @@ struct SDKLibFunctionPointers {
 	std::function<dv::Config::Node(dv::Module *, std::string_view)> outputGetInfoNode;
 	std::function<const dv::Config::Node(dv::Module *, std::string_view)> inputGetInfoNode;
 	std::function<bool(dv::Module *, std::string_view)> inputIsConnected;
+	std::function<void(dv::Module *, int64_t)> runTimeoutSet;
 };
 
 class MainData {
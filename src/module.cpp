@@ -499,18 +499,37 @@ void dv::Module::runStateMachine() {
 			}
 		}
 
-		// Only run if there is data. On timeout with no data, do nothing.
+		// Only run if there is data. On timeout with no data, do nothing,
+		// unless the module set a run timeout and that much time has passed
+		// since its last run, in which case it runs without new data.
 		// If is an input generation module (no inputs defined at all), always run.
 		if (inputs.size() > 0) {
+			// Wake up at least once per second to check for state changes.
+			auto waitDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			bool runOnTimeout = false;
+
+			const auto runTimeout = run.timeout.load(std::memory_order_relaxed);
+			if (runTimeout > 0) {
+				const auto runDeadline = run.lastRun + std::chrono::microseconds(runTimeout);
+
+				if (runDeadline <= waitDeadline) {
+					waitDeadline = runDeadline;
+					runOnTimeout = true;
+				}
+			}
+
 			std::unique_lock lock(dataAvailable.lock);
 
-			if (!dataAvailable.cond.wait_for(
-					lock, std::chrono::seconds(1), [this]() { return (dataAvailable.count > 0); })) {
+			if (!dataAvailable.cond.wait_until(
+					lock, waitDeadline, [this]() { return (dataAvailable.count > 0); })
+				&& !runOnTimeout) {
 				return;
 			}
 		}
 
 		if (info->functions->moduleRun != nullptr) {
+			run.lastRun = std::chrono::steady_clock::now();
+
 			try {
 				info->functions->moduleRun(this);
 			}
@@ -855,6 +874,24 @@ bool dv::Module::inputIsConnected(std::string_view inputName) {
 	return (input->linkedOutput != nullptr);
 }
 
+/**
+ * Set the maximum time between two runs of this module. If no new input
+ * data arrives within that time, the module is run anyway, so it can
+ * act on the passage of time alone. Has no effect on modules without
+ * inputs, as those always run.
+ *
+ * @param timeoutMicroseconds maximum time between runs in µs, 0 to only
+ * run on new input data (default).
+ */
+void dv::Module::runTimeoutSet(int64_t timeoutMicroseconds) {
+	if (timeoutMicroseconds < 0) {
+		auto msg = boost::format("Run timeout must be positive or zero, got %d.") % timeoutMicroseconds;
+		throw std::out_of_range(msg.str());
+	}
+
+	run.timeout.store(timeoutMicroseconds, std::memory_order_relaxed);
+}
+
 void dv::Module::moduleRunningListener(dvConfigNode node, void *userData, enum dvConfigAttributeEvents event,
 	const char *changeKey, enum dvConfigAttributeType changeType, union dvConfigAttributeValue changeValue) {
 	UNUSED_ARGUMENT(node);
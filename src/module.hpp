@@ -11,6 +11,7 @@
 #include <atomic>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <string>
@@ -111,8 +112,17 @@ struct RunControl {
 	std::atomic_bool isRunning;
 	std::atomic_bool configUpdate;
 	bool runDelay;
-
-	RunControl() : forcedShutdown(false), running(false), isRunning(false), configUpdate(false), runDelay(false) {
+	// Run even without new input data, once this many µs passed since the last run. 0 disables.
+	std::atomic_int64_t timeout;
+	std::chrono::steady_clock::time_point lastRun;
+
+	RunControl() :
+		forcedShutdown(false),
+		running(false),
+		isRunning(false),
+		configUpdate(false),
+		runDelay(false),
+		timeout(0) {
 	}
 };
 
@@ -155,6 +165,8 @@ public:
 	const dv::Config::Node inputGetInfoNode(std::string_view inputName);
 	bool inputIsConnected(std::string_view inputName);
 
+	void runTimeoutSet(int64_t timeoutMicroseconds);
+
 private:
 	void LoggingInit();
 	void RunningInit();
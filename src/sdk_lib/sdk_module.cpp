@@ -121,3 +121,14 @@ bool dvModuleInputIsConnected(dvModuleData moduleData, const char *name) {
 		return (false);
 	}
 }
+
+void dvModuleRunTimeoutSet(dvModuleData moduleData, int64_t timeoutMicroseconds) {
+	auto module = reinterpret_cast<dv::Module *>(moduleData);
+
+	try {
+		dv::glLibFuncPtr->runTimeoutSet(module, timeoutMicroseconds);
+	}
+	catch (const std::exception &ex) {
+		dv::Log(dv::logLevel::CRITICAL, "%s", ex.what());
+	}
+}